@@ -0,0 +1,71 @@
+#include "bot_controller.h"
+#include <array>
+#include <cstdlib>
+
+namespace {
+
+Snake::Direction Opposite(Snake::Direction direction) {
+  switch (direction) {
+    case Snake::Direction::kUp: return Snake::Direction::kDown;
+    case Snake::Direction::kDown: return Snake::Direction::kUp;
+    case Snake::Direction::kLeft: return Snake::Direction::kRight;
+    case Snake::Direction::kRight: return Snake::Direction::kLeft;
+  }
+  return direction;
+}
+
+}  // namespace
+
+BotController::BotController(int grid_width, int grid_height)
+    : grid_width_(grid_width),
+      grid_height_(grid_height) {}
+
+void BotController::Steer(Snake &snake, SDL_Point const &food) const {
+  auto head_pos = snake.GetSnakeHeadPosition();
+  SDL_Point head{static_cast<int>(head_pos.x), static_cast<int>(head_pos.y)};
+
+  int dx = WrappedDelta(head.x, food.x, grid_width_);
+  int dy = WrappedDelta(head.y, food.y, grid_height_);
+
+  // Candidate directions ordered by preference: close the larger gap first,
+  // then the smaller one, then anything that keeps the snake alive.
+  Snake::Direction current = snake.GetSnakeDirection();
+  Snake::Direction horizontal = dx < 0 ? Snake::Direction::kLeft : Snake::Direction::kRight;
+  Snake::Direction vertical = dy < 0 ? Snake::Direction::kUp : Snake::Direction::kDown;
+  bool x_first = std::abs(dx) >= std::abs(dy);
+  Snake::Direction primary = x_first ? horizontal : vertical;
+  Snake::Direction secondary = (dx == 0 || dy == 0) ? primary : (x_first ? vertical : horizontal);
+  std::array<Snake::Direction, 7> candidates{
+      primary, secondary, current,
+      Snake::Direction::kUp, Snake::Direction::kDown,
+      Snake::Direction::kLeft, Snake::Direction::kRight};
+
+  for (auto direction : candidates) {
+    if (snake.GetSize() > 1 && direction == Opposite(current)) continue;
+    if (!snake.SnakeCell(NextCell(head, direction))) {
+      snake.SetSnakeDirection(direction);
+      return;
+    }
+  }
+  // Every neighbour is blocked; keep going and let the game end.
+}
+
+SDL_Point BotController::NextCell(SDL_Point const &head, Snake::Direction direction) const {
+  SDL_Point next = head;
+  switch (direction) {
+    case Snake::Direction::kUp: next.y--; break;
+    case Snake::Direction::kDown: next.y++; break;
+    case Snake::Direction::kLeft: next.x--; break;
+    case Snake::Direction::kRight: next.x++; break;
+  }
+  next.x = (next.x + grid_width_) % grid_width_;
+  next.y = (next.y + grid_height_) % grid_height_;
+  return next;
+}
+
+int BotController::WrappedDelta(int from, int to, int extent) const {
+  int delta = to - from;
+  if (delta > extent / 2) delta -= extent;
+  if (delta < -extent / 2) delta += extent;
+  return delta;
+}
@@ -0,0 +1,31 @@
+#ifndef BOT_CONTROLLER_H
+#define BOT_CONTROLLER_H
+
+#include "SDL.h"
+#include "snake.h"
+
+// Drives the snake without a keyboard, used by the headless soak mode.
+// Greedy: heads for the food along the shortest wrapped path and avoids
+// steering into its own body when another direction is free.
+class BotController {
+ public:
+  BotController(int grid_width, int grid_height);
+  ~BotController() = default;
+
+  //Rule of 5 Implementation
+  BotController(const BotController& other) = delete;
+  BotController& operator=(const BotController& other) = delete;
+  BotController(BotController&& other) noexcept = delete;
+  BotController& operator=(BotController&& other) noexcept = delete;
+
+  void Steer(Snake &snake, SDL_Point const &food) const;
+
+ private:
+  SDL_Point NextCell(SDL_Point const &head, Snake::Direction direction) const;
+  int WrappedDelta(int from, int to, int extent) const;
+
+  int grid_width_;
+  int grid_height_;
+};
+
+#endif
@@ -9,33 +9,68 @@ void Controller::ChangeDirection(Snake &snake, const Snake::Direction& input,
   return;
 }
 
-void Controller::HandleInput(bool &running, Snake &snake) const {
+bool Controller::HandleInput(bool &running, bool &paused, bool &show_hud, Snake &snake) const {
   SDL_Event e;
+  bool redraw = false;
   while (SDL_PollEvent(&e)) {
-    if (e.type == SDL_QUIT) {
-      running = false;
-    } else if (e.type == SDL_KEYDOWN) {
-      switch (e.key.keysym.sym) {
-        case SDLK_UP:
-          ChangeDirection(snake, Snake::Direction::kUp,
-                          Snake::Direction::kDown);
-          break;
-
-        case SDLK_DOWN:
-          ChangeDirection(snake, Snake::Direction::kDown,
-                          Snake::Direction::kUp);
-          break;
-
-        case SDLK_LEFT:
-          ChangeDirection(snake, Snake::Direction::kLeft,
-                          Snake::Direction::kRight);
-          break;
-
-        case SDLK_RIGHT:
-          ChangeDirection(snake, Snake::Direction::kRight,
-                          Snake::Direction::kLeft);
-          break;
-      }
+    redraw |= HandleEvent(e, running, paused, show_hud, snake);
+  }
+  return redraw;
+}
+
+bool Controller::WaitForInput(bool &running, bool &paused, bool &show_hud, Snake &snake) const {
+  SDL_Event e;
+  if (!SDL_WaitEvent(&e)) return false;
+  bool redraw = HandleEvent(e, running, paused, show_hud, snake);
+  // Drain whatever else queued up behind the first event.
+  return HandleInput(running, paused, show_hud, snake) || redraw;
+}
+
+bool Controller::HandleEvent(SDL_Event const &e, bool &running, bool &paused, bool &show_hud,
+                             Snake &snake) const {
+  if (e.type == SDL_QUIT) {
+    running = false;
+  } else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+    return true;
+  } else if (e.type == SDL_WINDOWEVENT) {
+    return e.window.event == SDL_WINDOWEVENT_EXPOSED ||
+           e.window.event == SDL_WINDOWEVENT_SHOWN ||
+           e.window.event == SDL_WINDOWEVENT_RESTORED ||
+           e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED;
+  } else if (e.type == SDL_KEYDOWN) {
+    if (e.key.keysym.sym == SDLK_p || e.key.keysym.sym == SDLK_SPACE) {
+      if (!e.key.repeat && snake.IsSnakeAlive()) paused = !paused;
+      return true;
+    }
+    if (e.key.keysym.sym == SDLK_F3 || e.key.keysym.sym == SDLK_h) {
+      if (!e.key.repeat) show_hud = !show_hud;
+      return true;
     }
+    // Direction changes are ignored while the game is frozen.
+    if (paused || !snake.IsSnakeAlive()) return true;
+
+    switch (e.key.keysym.sym) {
+      case SDLK_UP:
+        ChangeDirection(snake, Snake::Direction::kUp,
+                        Snake::Direction::kDown);
+        break;
+
+      case SDLK_DOWN:
+        ChangeDirection(snake, Snake::Direction::kDown,
+                        Snake::Direction::kUp);
+        break;
+
+      case SDLK_LEFT:
+        ChangeDirection(snake, Snake::Direction::kLeft,
+                        Snake::Direction::kRight);
+        break;
+
+      case SDLK_RIGHT:
+        ChangeDirection(snake, Snake::Direction::kRight,
+                        Snake::Direction::kLeft);
+        break;
+    }
+    return true;
   }
-}
\ No newline at end of file
+  return false;
+}
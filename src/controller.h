@@ -1,11 +1,15 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include "SDL.h"
 #include "snake.h"
 
 class Controller {
  public:
-  void HandleInput(bool &running, Snake &snake) const;
+  // Both return true when an event means the frame should be redrawn.
+  bool HandleInput(bool &running, bool &paused, bool &show_hud, Snake &snake) const;
+  // Blocks until the next event arrives, used while idle.
+  bool WaitForInput(bool &running, bool &paused, bool &show_hud, Snake &snake) const;
 
   Controller() = default;
   ~Controller() = default;
@@ -17,6 +21,8 @@ class Controller {
   Controller& operator=(Controller&& other) noexcept = delete;
 
  private:
+  bool HandleEvent(SDL_Event const &e, bool &running, bool &paused, bool &show_hud,
+                   Snake &snake) const;
   void ChangeDirection(Snake &snake, const Snake::Direction& input,
                        Snake::Direction opposite) const;
 };
@@ -1,6 +1,25 @@
 #include "game.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include "SDL.h"
+#include "trace.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Flushes a file, or a directory's entries, to disk by path.
+bool SyncPath(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+}
+
+}  // namespace
 
 GameConfig::GameConfig(const std::string& config_file) : highest_score_{},
                                                          game_settings_{
@@ -10,7 +29,10 @@ GameConfig::GameConfig(const std::string& config_file) : highest_score_{},
                                                                          640,                  // screen_height - default window height
                                                                          32,                   // grid_width - default game grid width
                                                                          32                    // grid_height - default game grid height
-                                                                     }
+                                                                     },
+                                                         score_database_{"../src/snake_scores"},
+                                                         trace_file_{},
+                                                         level_file_{}
 
 { 
   LoadConfig(config_file);
@@ -49,17 +71,33 @@ void GameConfig::LoadConfig(const std::string& file_name)
             line_stream >> game_settings_.grid_height;
         } else if (key == "HighestScore") {
             line_stream >> highest_score_;
+        } else if (key == "ScoreDatabase") {
+            line_stream >> score_database_;
+        } else if (key == "TraceFile") {
+            line_stream >> trace_file_;
+        } else if (key == "LevelFile") {
+            line_stream >> level_file_;
         }
     }
+
+    // FramePerSeconds only caps the render rate, the simulation rate is fixed
+    if (game_settings_.frames_per_second == 0) {
+        std::cerr << "FramePerSeconds must be positive, using 60\n";
+        game_settings_.frames_per_second = 60;
+    }
+    game_settings_.ms_per_frame = 1000 / game_settings_.frames_per_second;
 }
 
 //File I/O Operations
+// Writes to a temporary file, fsyncs it and renames it over the config, so a
+// crash or power loss mid-write leaves the previous settings intact.
 void GameConfig::SaveConfig(const std::string& filename) 
 {
-        std::ofstream config_file(filename, std::ios::out | std::ios::trunc);
+    const std::string temp_filename = filename + ".tmp";
+    std::ofstream config_file(temp_filename, std::ios::out | std::ios::trunc);
     
     if (!config_file.is_open()) {
-        std::cerr << "Failed to open file for writing: " << filename << "\n";
+        std::cerr << "Failed to open file for writing: " << temp_filename << "\n";
         return;
     }
 
@@ -70,12 +108,16 @@ void GameConfig::SaveConfig(const std::string& filename)
                << "ScreenWidth: " << game_settings_.screen_width << "\n"
                << "ScreenHeight: " << game_settings_.screen_height << "\n"
                << "GridWidth: " << game_settings_.grid_width << "\n"
-               << "GridHeight: " << game_settings_.grid_width << "\n\n\n";
+               << "GridHeight: " << game_settings_.grid_height << "\n"
+               << "ScoreDatabase: " << score_database_ << "\n";
 
-    // Write the score section separately to ensure it's not being skipped
-    config_file << "Game Score:\n"
-               << "------------\n"
-               << "HighestScore: " << highest_score_ << "\n";
+    // Tracing is opt-in, only keep the key if it was configured
+    if (!trace_file_.empty()) {
+        config_file << "TraceFile: " << trace_file_ << "\n";
+    }
+    if (!level_file_.empty()) {
+        config_file << "LevelFile: " << level_file_ << "\n";
+    }
 
     // Force the write to disk
     config_file.flush();
@@ -83,19 +125,49 @@ void GameConfig::SaveConfig(const std::string& filename)
     // Check if any errors occurred during writing
     if (config_file.fail()) {
         std::cerr << "Error occurred while writing to file\n";
+        config_file.close();
+        std::remove(temp_filename.c_str());
+        return;
     }
 
     config_file.close();
+
+    // Without this the rename can reach the disk before the data does
+    if (!SyncPath(temp_filename)) {
+        std::cerr << "Failed to sync config file: " << temp_filename << "\n";
+        std::remove(temp_filename.c_str());
+        return;
+    }
+
+    if (std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Failed to replace config file: " << filename << "\n";
+        std::remove(temp_filename.c_str());
+        return;
+    }
+
+    // The rename itself is only durable once the directory entry is synced
+    std::string::size_type slash = filename.find_last_of('/');
+    SyncPath(slash == std::string::npos ? "." : filename.substr(0, slash + 1));
 }
 
-void GameConfig::SetNewHighScore(int new_score)
+int GameConfig::GetLegacyHighScore() const
 {
-  highest_score_ = new_score;
-} 
+  return highest_score_;
+}
 
-int GameConfig::GetHighestScore() const
+const std::string& GameConfig::GetScoreDatabase() const
 {
-  return highest_score_;
+  return score_database_;
+}
+
+const std::string& GameConfig::GetTraceFile() const
+{
+  return trace_file_;
+}
+
+const std::string& GameConfig::GetLevelFile() const
+{
+  return level_file_;
 }
 
 GameSettings GameConfig::GetGameSettings() const
@@ -103,8 +175,12 @@ GameSettings GameConfig::GetGameSettings() const
   return game_settings_;
 }
 
-Game::Game(std::size_t& grid_width, std::size_t& grid_height)
+Game::Game(std::size_t& grid_width, std::size_t& grid_height, const Level* level)
     : snake(grid_width, grid_height),
+      grid_width_(static_cast<int>(grid_width)),
+      grid_height_(static_cast<int>(grid_height)),
+      wall_count_(level != nullptr ? level->GetWallCount() : 0),
+      level_(level),
       engine(dev()),
       random_w(0, static_cast<int>(grid_width - 1)),
       random_h(0, static_cast<int>(grid_height - 1)),
@@ -115,10 +191,15 @@ Game::Game(std::size_t& grid_width, std::size_t& grid_height)
       original_speed_{0.1f},
       terminate_{},
       poison_start_time_{},             
+      last_poison_spawn_{0},
+      poison_expire_time_{0},
+      sim_steps_{0},
       poison_mutex_{},                   
       poison_cv_{},                      
       poison_food_thread_{} 
 {
+  // Walls are part of the snake's occupancy, so food never lands on them.
+  snake.SetLevel(level);
   PlaceFood();
 }
 
@@ -148,7 +229,9 @@ void Game::StartPoisonFoodThread() {
         }
         
         PlacePoisonFood();
+        poison_expire_time_ = SimTimeMs() + 5000;  // Poison food stays for 5 seconds
         is_poison_food_active_ = true;
+        Tracer::Instance().Instant("PoisonSpawned");
         
         // Start new thread
         poison_food_thread_ = std::thread(&Game::PoisonFoodTimer, this);
@@ -169,70 +252,231 @@ Game::~Game() {
 }
 
 void Game::PoisonFoodTimer() {
-    const int poison_duration = 5;  // Poison food stays for 5 seconds
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
+    Tracer::Instance().RegisterThread("PoisonFoodThread");
+    TraceScope trace_scope("PoisonFoodTimer");
+
     std::unique_lock<std::mutex> lock(poison_mutex_);
-    
-    while (!terminate_ && is_poison_food_active_) {
-        lock.unlock();
-        
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(
-            current_time - start_time).count();
-            
-        if (elapsed_seconds >= poison_duration) {
-            std::lock_guard<std::mutex> remove_lock(poison_mutex_);
-            is_poison_food_active_ = false;
-            poison_food_ = {-1, -1};  // Move off screen
-            break;
-        }
-        
-        lock.lock();
-        poison_cv_.wait_for(lock, std::chrono::milliseconds(800));
+    {
+        // The lifetime is measured on the simulation clock, which stands
+        // still while paused or after game over. Every change the predicate
+        // depends on notifies: Update once the expiry time passes,
+        // ConsumeCell when the poison is eaten and ~Game on shutdown.
+        TraceScope wait_scope("PoisonWait");
+        poison_cv_.wait(lock, [this] {
+            return terminate_ || !is_poison_food_active_ || SimTimeMs() >= poison_expire_time_;
+        });
+    }
+
+    if (!terminate_ && is_poison_food_active_) {
+        is_poison_food_active_ = false;
+        poison_food_ = {-1, -1};  // Move off screen
+        Tracer::Instance().Instant("PoisonExpired");
     }
 }
 
 void Game::Run(Controller const &controller, Renderer &renderer,
                std::size_t& target_frame_duration) {
+  const Uint32 hud_refresh_ms = 250;
+  const double max_frame_skip_ms = 100.0;  // show a frame at least this often under load
+  const double counter_ms = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
   Uint32 title_timestamp = SDL_GetTicks();
+  Uint32 hud_timestamp = title_timestamp;
   Uint32 frame_start;
   Uint32 frame_end;
   Uint32 frame_duration;
   int frame_count = 0;
   bool running = true;
+  bool paused = false;
+  bool redraw = true;
+  bool show_hud = false;
+  double accumulator_ms = 0.0;
+  // A normal frame at the capped rate plus a few steps of catch-up, so a low
+  // FramePerSeconds never runs into the cap.
+  const int max_steps_per_frame =
+      static_cast<int>(std::ceil(target_frame_duration / kSimStepMs)) + kCatchUpSteps;
+  FrameState last_frame = CaptureFrameState();
+  FrameStats frame_stats;
+  Uint64 previous_frame_counter = SDL_GetPerformanceCounter();
+  Uint64 last_render_counter = previous_frame_counter;
 
   while (running) {
+    TraceScope frame_scope("Frame");
     frame_start = SDL_GetTicks();
+    Uint64 frame_counter = SDL_GetPerformanceCounter();
+    bool hud_was_visible = show_hud;
+    bool was_paused = paused;
+    bool was_alive = snake.IsSnakeAlive();
+    bool idle = paused || !was_alive;
 
     // Input, Update, Render - the main game loop.
-    controller.HandleInput(running, snake);
-    Update();
-    renderer.Render(snake, food, poison_food_, is_poison_food_active_);
+    if (idle) {
+      // Nothing moves while paused or after game over, and the simulation
+      // clock is frozen so no timer can fire either. Block on the event
+      // queue instead of re-rendering the same frame every tick.
+      TraceScope idle_scope("Idle");
+      redraw |= controller.WaitForInput(running, paused, show_hud, snake);
+    } else {
+      TraceScope input_scope("Input");
+      redraw |= controller.HandleInput(running, paused, show_hud, snake);
+    }
+
+    // No frames are timed while idle, so the numbers are only refreshed when
+    // the overlay is opened rather than redrawn unchanged on every tick.
+    bool hud_opened = show_hud && !hud_was_visible;
+    if (show_hud != hud_was_visible) {
+      renderer.SetHudVisible(show_hud);
+    }
+    if (hud_opened || (show_hud && !idle && frame_start - hud_timestamp >= hud_refresh_ms)) {
+      renderer.SetHudStats(CaptureHudStats(frame_stats));
+      hud_timestamp = frame_start;
+      redraw = true;
+    }
+
+    if (paused && !was_paused) {
+      renderer.UpdateWindowTitle(score, "Paused");
+    }
+
+    // Real time since the last frame is paid out in fixed simulation steps,
+    // so the game runs at the same speed whatever the frame rate. Time spent
+    // idle is never owed to the simulation.
+    if (!idle && !paused) {
+      accumulator_ms += (frame_counter - previous_frame_counter) * counter_ms;
+    }
+    int steps = 0;
+    Uint64 update_start = SDL_GetPerformanceCounter();
+    while (accumulator_ms >= kSimStepMs && steps < max_steps_per_frame && snake.IsSnakeAlive()) {
+      TraceScope update_scope("Update");
+      Update();
+      accumulator_ms -= kSimStepMs;
+      steps++;
+    }
+    if (accumulator_ms >= kSimStepMs) {
+      if (snake.IsSnakeAlive()) Tracer::Instance().Instant("StepsDropped");
+      accumulator_ms = std::fmod(accumulator_ms, kSimStepMs);
+    }
+    Uint64 update_end = SDL_GetPerformanceCounter();
+    if (was_alive && !snake.IsSnakeAlive()) {
+      renderer.UpdateWindowTitle(score, "Game Over");
+    }
+
+    // Skip the redraw when nothing visible changed, e.g. while the head is
+    // still inside the same cell. A frame that had to run the full catch-up
+    // is dropped too, unless nothing has been shown for max_frame_skip_ms.
+    FrameState frame = CaptureFrameState();
+    bool behind = steps >= max_steps_per_frame &&
+                  (update_end - last_render_counter) * counter_ms < max_frame_skip_ms;
+    if ((redraw || FrameChanged(last_frame, frame)) && !behind) {
+      TraceScope render_scope("Render");
+      renderer.Render(snake, food, poison_food_, is_poison_food_active_);
+      last_frame = frame;
+      redraw = false;
+      last_render_counter = SDL_GetPerformanceCounter();
+    }
+    Uint64 render_end = SDL_GetPerformanceCounter();
+
+    if (idle || paused) {
+      previous_frame_counter = SDL_GetPerformanceCounter();
+      frame_count = 0;
+      title_timestamp = SDL_GetTicks();
+      continue;
+    }
 
     frame_end = SDL_GetTicks();
 
+    // Frame time is start to start, so it includes the delay of the frame before
+    frame_stats.AddFrame(static_cast<float>((frame_counter - previous_frame_counter) * counter_ms),
+                         static_cast<float>((update_end - update_start) * counter_ms),
+                         static_cast<float>((render_end - update_end) * counter_ms));
+    previous_frame_counter = frame_counter;
+
     // Keep track of how long each loop through the input/update/render cycle
     // takes.
     frame_count++;
     frame_duration = frame_end - frame_start;
 
     // After every second, update the window title.
-    if (frame_end - title_timestamp >= 1000) {
+    if (frame_end - title_timestamp >= 1000 && snake.IsSnakeAlive()) {
       renderer.UpdateWindowTitle(score, frame_count);
       frame_count = 0;
       title_timestamp = frame_end;
     }
 
     // If the time for this frame is too small (i.e. frame_duration is
-    // smaller than the target ms_per_frame), delay the loop to
-    // achieve the correct frame rate.
+    // smaller than the target ms_per_frame), delay the loop. This only caps
+    // the frame rate, the simulation speed does not depend on it.
     if (frame_duration < target_frame_duration) {
+      TraceScope delay_scope("Delay");
       SDL_Delay(target_frame_duration - frame_duration);
     }
   }
 }
 
+HudStats Game::CaptureHudStats(FrameStats& frame_stats) {
+  HudStats stats{};
+  frame_stats.Fill(stats);
+  stats.snake_length = snake.GetSize();
+  stats.free_cells = grid_width_ * grid_height_ - static_cast<int>(wall_count_) -
+                     static_cast<int>(snake.body_.size()) - 1;
+  std::lock_guard<std::mutex> lock(poison_mutex_);
+  stats.poison_food_active = is_poison_food_active_;
+  stats.snake_poisoned = is_snake_poisoned_;
+  return stats;
+}
+
+Game::FrameState Game::CaptureFrameState() {
+  auto head = snake.GetSnakeHeadPosition();
+  std::lock_guard<std::mutex> lock(poison_mutex_);
+  return FrameState{{static_cast<int>(head.x), static_cast<int>(head.y)},
+                    snake.GetSize(),
+                    food,
+                    poison_food_,
+                    is_poison_food_active_,
+                    snake.IsSnakeAlive()};
+}
+
+bool Game::FrameChanged(const FrameState& previous, const FrameState& current) const {
+  return previous.head.x != current.head.x || previous.head.y != current.head.y ||
+         previous.size != current.size ||
+         previous.food.x != current.food.x || previous.food.y != current.food.y ||
+         previous.poison_food.x != current.poison_food.x ||
+         previous.poison_food.y != current.poison_food.y ||
+         previous.poison_active != current.poison_active ||
+         previous.alive != current.alive;
+}
+
+Uint32 Game::SimTimeMs() const {
+  return static_cast<Uint32>(sim_steps_ * 1000 / kSimStepsPerSecond);
+}
+
+// Headless loop for the soak mode: the bot plays until the snake dies or the
+// soak run is over. Ticks are paced at the fixed simulation step like Run.
+void Game::RunHeadless(BotController const &bot, SoakMonitor &monitor) {
+  const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double, std::milli>(kSimStepMs));
+  auto next_tick = std::chrono::steady_clock::now();
+
+  while (snake.IsSnakeAlive() && !monitor.IsFinished()) {
+    auto tick_start = std::chrono::steady_clock::now();
+
+    bot.Steer(snake, food);
+    Update();
+
+    auto tick_micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - tick_start).count();
+    monitor.RecordTick(static_cast<std::uint64_t>(tick_micros), snake.GetSize());
+
+    // Same fixed step as the windowed game, without rendering.
+    next_tick += step;
+    auto now = std::chrono::steady_clock::now();
+    if (next_tick > now) {
+      std::this_thread::sleep_until(next_tick);
+    } else {
+      next_tick = now;  // fell behind, do not try to catch up
+    }
+  }
+  monitor.RecordGameOver(score);
+}
+
 void Game::PlaceFood() {
   int x, y;
   while (true) {
@@ -252,60 +496,139 @@ void Game::PlaceFood() {
 void Game::Update() {
     if (!snake.IsSnakeAlive()) return;
 
-    snake.Update();
+    // Food and poison are checked in every cell the head crosses, so nothing
+    // is skipped when the snake moves more than one cell per tick.
+    snake.Update([this](const SDL_Point& cell) { ConsumeCell(cell); });
+    if (!snake.IsSnakeAlive()) {
+        Tracer::Instance().Instant("SnakeDied");
+    }
+
+    // Advance the simulation clock and wake the poison worker once the
+    // poison food's lifetime is over.
+    Uint32 current_time;
+    bool poison_expired;
+    {
+        std::lock_guard<std::mutex> lock(poison_mutex_);
+        sim_steps_++;
+        current_time = SimTimeMs();
+        poison_expired = is_poison_food_active_ && current_time >= poison_expire_time_;
+    }
+    if (poison_expired) {
+        poison_cv_.notify_all();
+    }
     
     // Check if it's time to spawn new poison food (every 10 seconds)
-    static Uint32 last_poison_spawn = SDL_GetTicks();
-    Uint32 current_time = SDL_GetTicks();
     
-    if (current_time - last_poison_spawn >= 10000) 
+    if (current_time - last_poison_spawn_ >= 10000) 
     {
         StartPoisonFoodThread();
-        last_poison_spawn = current_time;
+        last_poison_spawn_ = current_time;
     }
 
-    // Handle regular food collision (existing code)
-    auto snake_head_pos = snake.GetSnakeHeadPosition();
-    int new_x = static_cast<int>(snake_head_pos.x);
-    int new_y = static_cast<int>(snake_head_pos.y);
+    // Handle poison effect duration in the main loop
+    if (is_snake_poisoned_) {
+        if (current_time - poison_start_time_ >= 3000) {  // 3 seconds
+            is_snake_poisoned_ = false;
+            snake.SetSpeed(original_speed_);
+            poison_start_time_ = 0;
+        }
+    }
+}
 
+void Game::ConsumeCell(const SDL_Point& cell) {
+    int new_x = cell.x;
+    int new_y = cell.y;
+
+    // Handle regular food collision
     if (food.x == new_x && food.y == new_y) {
         score++;
+        Tracer::Instance().Instant("FoodEaten");
         PlaceFood();
         snake.GrowBody();
         snake.IncreaseSpeed();
     }
 
     // Handle poison food collision
+    bool poison_eaten = false;
     {
         std::lock_guard<std::mutex> lock(poison_mutex_);
-        if (is_poison_food_active_ && 
+        // Expired poison may not have been cleared by its worker yet.
+        if (is_poison_food_active_ && SimTimeMs() < poison_expire_time_ &&
             poison_food_.x == new_x && poison_food_.y == new_y) {
             
             if (!is_snake_poisoned_) {
                 is_snake_poisoned_ = true;
+                Tracer::Instance().Instant("PoisonConsumed");
                 original_speed_ = snake.GetSpeed();
                 snake.SetSpeed(original_speed_ * 0.5f);  // Reduce to half speed
                 
                 // Instead of creating a new thread, use a timer
-                poison_start_time_ = SDL_GetTicks();
+                poison_start_time_ = SimTimeMs();
                 
                 // Move poison effect handling to the main game loop
                 is_poison_food_active_ = false;
                 poison_food_ = {-1, -1};
+                poison_eaten = true;
             }
         }
     }
-    
-    // Handle poison effect duration in the main loop
-    if (is_snake_poisoned_) {
-        if (SDL_GetTicks() - poison_start_time_ >= 3000) {  // 3 seconds
-            is_snake_poisoned_ = false;
-            snake.SetSpeed(original_speed_);
-            poison_start_time_ = 0;
-        }
+    if (poison_eaten) {
+        poison_cv_.notify_all();  // let the worker exit before the next spawn joins it
     }
 }
 
+Game::StepResult Game::Step(int action) {
+  if (!snake.IsSnakeAlive()) return StepResult{0.0f, true};
+
+  if (action >= 0 && action <= 3) {
+    static const Snake::Direction opposite[] = {Snake::Direction::kDown, Snake::Direction::kUp,
+                                                Snake::Direction::kRight, Snake::Direction::kLeft};
+    if (snake.GetSnakeDirection() != opposite[action] || snake.GetSize() == 1) {
+      snake.SetSnakeDirection(static_cast<Snake::Direction>(action));
+    }
+  }
+
+  int previous_score = score;
+  bool was_poisoned = is_snake_poisoned_;
+  Update();
+
+  float reward = static_cast<float>(score - previous_score);
+  if (is_snake_poisoned_ && !was_poisoned) reward -= 0.5f;
+  if (!snake.IsSnakeAlive()) reward -= 1.0f;
+  return StepResult{reward, !snake.IsSnakeAlive()};
+}
+
+void Game::WriteStaticObservation(std::uint8_t* observation) {
+  const std::size_t plane = static_cast<std::size_t>(grid_width_) * grid_height_;
+  std::uint8_t* walls = observation + kDynamicChannels * plane;
+  std::fill(walls, walls + plane, 0);
+  if (wall_count_ == 0) return;
+
+  for (int y = 0; y < grid_height_; ++y) {
+    for (int x = 0; x < grid_width_; ++x) {
+      walls[static_cast<std::size_t>(y) * grid_width_ + x] = level_->IsWall(x, y) ? 1 : 0;
+    }
+  }
+}
+
+void Game::WriteObservation(std::uint8_t* observation) {
+  const std::size_t plane = static_cast<std::size_t>(grid_width_) * grid_height_;
+  std::fill(observation, observation + kDynamicChannels * plane, 0);
+
+  auto cell = [this](int x, int y) { return static_cast<std::size_t>(y) * grid_width_ + x; };
+
+  for (SDL_Point const &point : snake.body_) {
+    observation[cell(point.x, point.y)] = 1;
+  }
+  auto head = snake.GetSnakeHeadPosition();
+  observation[plane + cell(static_cast<int>(head.x), static_cast<int>(head.y))] = 1;
+  observation[2 * plane + cell(food.x, food.y)] = 1;
+
+  std::lock_guard<std::mutex> lock(poison_mutex_);
+  if (is_poison_food_active_ && poison_food_.x >= 0 && poison_food_.y >= 0) {
+    observation[3 * plane + cell(poison_food_.x, poison_food_.y)] = 1;
+  }
+}
+
 int Game::GetScore() const { return score; }
 int Game::GetSize() const { return snake.GetSize(); }
\ No newline at end of file
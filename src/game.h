@@ -3,14 +3,18 @@
 
 #include <random>
 #include "SDL.h"
+#include "bot_controller.h"
 #include "controller.h"
 #include "renderer.h"
 #include "snake.h"
+#include "soak_monitor.h"
 #include <fstream>  
 #include <sstream>  
 #include <future>
 #include <thread>   
 #include <chrono>
+#include <cstdint>
+#include <string>
 
 struct GameSettings
 {
@@ -36,17 +40,23 @@ class GameConfig
    void SaveConfig(const std::string&); 
    void LoadConfig(const std::string&); 
    GameSettings GetGameSettings() const;
-   int GetHighestScore() const;
-   void SetNewHighScore(int);
+   // HighestScore from config files older than the score database
+   int GetLegacyHighScore() const;
+   const std::string& GetScoreDatabase() const;
+   const std::string& GetTraceFile() const;
+   const std::string& GetLevelFile() const;
   private:
     int highest_score_;
     GameSettings game_settings_;
+    std::string score_database_;
+    std::string trace_file_;   // empty unless tracing is enabled
+    std::string level_file_;   // empty for the open wrapped grid
 };
 
 
 class Game {
  public:
-  Game(std::size_t& grid_width, std::size_t& grid_height);
+  Game(std::size_t& grid_width, std::size_t& grid_height, const Level* level = nullptr);
   ~Game();
 
   //Rule of 5 Implementation
@@ -57,6 +67,30 @@ class Game {
 
   void Run(Controller const &controller, Renderer &renderer,
            std::size_t& target_frame_duration);
+  void RunHeadless(BotController const &bot, SoakMonitor &monitor);
+
+  // The simulation always advances in fixed steps, the frame rate only
+  // limits how often it is drawn. Speeds are in cells per step.
+  static constexpr int kSimStepsPerSecond = 60;
+  static constexpr double kSimStepMs = 1000.0 / kSimStepsPerSecond;
+  // Steps on top of one frame's worth that may run to catch up after a stall,
+  // the rest of the backlog is dropped so a slow machine plays slower
+  // instead of spiralling.
+  static constexpr int kCatchUpSteps = 4;
+
+  // Reinforcement-learning interface: one Step is one Update. Actions 0-3
+  // follow Snake::Direction order, any other value keeps the direction.
+  struct StepResult {
+    float reward;
+    bool done;
+  };
+  static constexpr int kObservationChannels = 5;  // body, head, food, poison, walls
+  static constexpr int kDynamicChannels = 4;      // rewritten after every step
+  StepResult Step(int action);
+  // The observation is a dense [channel][grid_height][grid_width] uint8 grid.
+  // The walls channel never changes, so it is written once per game.
+  void WriteStaticObservation(std::uint8_t* observation);
+  void WriteObservation(std::uint8_t* observation);
   
   //Setters & Getters
   int GetScore() const;
@@ -66,6 +100,10 @@ class Game {
 
   Snake snake;
   SDL_Point food;
+  const int grid_width_;
+  const int grid_height_;
+  const std::size_t wall_count_;
+  const Level* level_;
 
   std::random_device dev;
   std::mt19937 engine;
@@ -81,6 +119,11 @@ class Game {
     float original_speed_;
     bool terminate_;    
     uint32_t poison_start_time_;       
+    Uint32 last_poison_spawn_;
+    Uint32 poison_expire_time_;
+    // Fixed steps simulated so far; all gameplay timers run on this clock,
+    // so they stop while paused. Written under poison_mutex_.
+    std::uint64_t sim_steps_;
     
     // Thread synchronization members
     std::mutex poison_mutex_;            
@@ -92,8 +135,23 @@ class Game {
     void StartPoisonFoodThread();       
     void PlacePoisonFood();             
 
+  // Everything visible on screen, a frame is only redrawn when it changes.
+  struct FrameState {
+    SDL_Point head;
+    int size;
+    SDL_Point food;
+    SDL_Point poison_food;
+    bool poison_active;
+    bool alive;
+  };
+  FrameState CaptureFrameState();
+  HudStats CaptureHudStats(FrameStats& frame_stats);
+  bool FrameChanged(const FrameState& previous, const FrameState& current) const;
+  Uint32 SimTimeMs() const;
+
   void PlaceFood();
   void Update();
+  void ConsumeCell(const SDL_Point& cell);
 };
 
 #endif
\ No newline at end of file
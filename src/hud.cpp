@@ -0,0 +1,187 @@
+#include "hud.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+struct FontGlyph {
+  char character;
+  Uint8 rows[7];  // bit 4 is the leftmost column
+};
+
+// Built-in 5x7 font, just enough characters for the overlay.
+const FontGlyph kFont[] = {
+    {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'A', {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}},
+    {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+    {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+    {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+    {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+    {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+    {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+    {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+    {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+    {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+    {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+    {'Y', {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},
+    {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+    {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+    {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'(', {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},
+    {')', {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},
+    {'=', {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}},
+};
+
+constexpr int kFontSize = static_cast<int>(sizeof(kFont) / sizeof(kFont[0]));
+
+}  // namespace
+
+void FrameStats::AddFrame(float frame_ms, float update_ms, float render_ms) {
+  frame_ms_[next_] = frame_ms;
+  next_ = (next_ + 1) % kWindow;
+  count_ = std::min(count_ + 1, kWindow);
+  update_ms_sum_ += update_ms;
+  render_ms_sum_ += render_ms;
+  period_frames_++;
+}
+
+void FrameStats::Fill(HudStats& stats) {
+  if (count_ > 0) {
+    std::array<float, kWindow> sorted = frame_ms_;
+    auto end = sorted.begin() + static_cast<std::ptrdiff_t>(count_);
+    auto p50 = sorted.begin() + static_cast<std::ptrdiff_t>((count_ - 1) / 2);
+    auto p99 = sorted.begin() + static_cast<std::ptrdiff_t>((count_ - 1) * 99 / 100);
+    std::nth_element(sorted.begin(), p99, end);
+    stats.frame_p99_ms = *p99;
+    std::nth_element(sorted.begin(), p50, p99);
+    stats.frame_p50_ms = *p50;
+  }
+  if (period_frames_ > 0) {
+    stats.update_ms = update_ms_sum_ / period_frames_;
+    stats.render_ms = render_ms_sum_ / period_frames_;
+  }
+  update_ms_sum_ = 0;
+  render_ms_sum_ = 0;
+  period_frames_ = 0;
+}
+
+bool GlyphAtlas::Build(SDL_Renderer* sdl_renderer) {
+  Destroy();
+  glyph_index_.fill(-1);
+
+  atlas_width_ = kFontSize * kCellWidth;
+  std::vector<Uint32> pixels(static_cast<std::size_t>(atlas_width_) * kCellHeight, 0x00FFFFFF);
+  for (int glyph = 0; glyph < kFontSize; ++glyph) {
+    glyph_index_[static_cast<unsigned char>(kFont[glyph].character)] = glyph;
+    for (int row = 0; row < kGlyphHeight; ++row) {
+      for (int column = 0; column < kGlyphWidth; ++column) {
+        if (kFont[glyph].rows[row] & (0x10 >> column)) {
+          pixels[row * atlas_width_ + glyph * kCellWidth + column] = 0xFFFFFFFF;
+        }
+      }
+    }
+  }
+
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+  texture_ = SDL_CreateTexture(sdl_renderer, SDL_PIXELFORMAT_ARGB8888,
+                               SDL_TEXTUREACCESS_STATIC, atlas_width_, kCellHeight);
+  if (nullptr == texture_) {
+    std::cerr << "Glyph atlas could not be created.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    return false;
+  }
+  SDL_UpdateTexture(texture_, nullptr, pixels.data(), atlas_width_ * static_cast<int>(sizeof(Uint32)));
+  SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+  return true;
+}
+
+void GlyphAtlas::Destroy() {
+  if (texture_ != nullptr) SDL_DestroyTexture(texture_);
+  texture_ = nullptr;
+}
+
+SDL_Rect GlyphAtlas::Measure(const std::vector<std::string>& lines, int scale) {
+  std::size_t longest = 0;
+  for (auto const& line : lines) longest = std::max(longest, line.size());
+  return SDL_Rect{0, 0, static_cast<int>(longest) * kCellWidth * scale,
+                  static_cast<int>(lines.size()) * kCellHeight * scale};
+}
+
+SDL_Rect GlyphAtlas::DrawLines(SDL_Renderer* sdl_renderer, const std::vector<std::string>& lines,
+                               int x, int y, int scale, SDL_Color color) {
+  SDL_Rect bounds = Measure(lines, scale);
+  bounds.x = x;
+  bounds.y = y;
+  if (texture_ == nullptr) return bounds;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  vertices_.clear();
+  indices_.clear();
+#else
+  SDL_SetTextureColorMod(texture_, color.r, color.g, color.b);
+#endif
+
+  for (std::size_t line = 0; line < lines.size(); ++line) {
+    for (std::size_t i = 0; i < lines[line].size(); ++i) {
+      unsigned char character = static_cast<unsigned char>(lines[line][i]);
+      int glyph = character < 128 ? glyph_index_[character] : -1;
+      if (glyph <= 0) continue;  // unknown characters and spaces draw nothing
+
+      float left = static_cast<float>(x + static_cast<int>(i) * kCellWidth * scale);
+      float top = static_cast<float>(y + static_cast<int>(line) * kCellHeight * scale);
+      float right = left + kGlyphWidth * scale;
+      float bottom = top + kGlyphHeight * scale;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+      float u0 = static_cast<float>(glyph * kCellWidth) / atlas_width_;
+      float u1 = static_cast<float>(glyph * kCellWidth + kGlyphWidth) / atlas_width_;
+      float v1 = static_cast<float>(kGlyphHeight) / kCellHeight;
+      int base = static_cast<int>(vertices_.size());
+      vertices_.push_back(SDL_Vertex{{left, top}, color, {u0, 0.0f}});
+      vertices_.push_back(SDL_Vertex{{right, top}, color, {u1, 0.0f}});
+      vertices_.push_back(SDL_Vertex{{right, bottom}, color, {u1, v1}});
+      vertices_.push_back(SDL_Vertex{{left, bottom}, color, {u0, v1}});
+      for (int corner : {0, 1, 2, 0, 2, 3}) indices_.push_back(base + corner);
+#else
+      // Older SDL has no geometry API, fall back to one copy per glyph.
+      SDL_Rect source{glyph * kCellWidth, 0, kGlyphWidth, kGlyphHeight};
+      SDL_Rect target{static_cast<int>(left), static_cast<int>(top), kGlyphWidth * scale, kGlyphHeight * scale};
+      SDL_RenderCopy(sdl_renderer, texture_, &source, &target);
+#endif
+    }
+  }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  if (!indices_.empty()) {
+    SDL_RenderGeometry(sdl_renderer, texture_, vertices_.data(), static_cast<int>(vertices_.size()),
+                       indices_.data(), static_cast<int>(indices_.size()));
+  }
+#endif
+  return bounds;
+}
@@ -0,0 +1,88 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "SDL.h"
+
+// Values shown by the performance overlay.
+struct HudStats
+{
+  float frame_p50_ms;
+  float frame_p99_ms;
+  float update_ms;
+  float render_ms;
+  int snake_length;
+  int free_cells;
+  bool poison_food_active;
+  bool snake_poisoned;
+};
+
+// Rolling window of recent frame timings for the overlay.
+class FrameStats {
+ public:
+  FrameStats() = default;
+  ~FrameStats() = default;
+
+  //Rule of 5 Implementation
+  FrameStats(const FrameStats& other) = delete;
+  FrameStats& operator=(const FrameStats& other) = delete;
+  FrameStats(FrameStats&& other) noexcept = delete;
+  FrameStats& operator=(FrameStats&& other) noexcept = delete;
+
+  void AddFrame(float frame_ms, float update_ms, float render_ms);
+  // Fills the timing fields of stats and starts a new averaging period.
+  void Fill(HudStats& stats);
+
+ private:
+  static constexpr std::size_t kWindow = 240;
+
+  std::array<float, kWindow> frame_ms_{};
+  std::size_t next_{0};
+  std::size_t count_{0};
+  float update_ms_sum_{0};
+  float render_ms_sum_{0};
+  int period_frames_{0};
+};
+
+// Texture holding every glyph of the built-in 5x7 font, built once at
+// startup. A block of text is drawn as a single batched geometry call.
+class GlyphAtlas {
+ public:
+  GlyphAtlas() = default;
+  ~GlyphAtlas() = default;
+
+  //Rule of 5 Implementation
+  GlyphAtlas(const GlyphAtlas& other) = delete;
+  GlyphAtlas& operator=(const GlyphAtlas& other) = delete;
+  GlyphAtlas(GlyphAtlas&& other) noexcept = delete;
+  GlyphAtlas& operator=(GlyphAtlas&& other) noexcept = delete;
+
+  bool Build(SDL_Renderer* sdl_renderer);
+  // Must run before the owning SDL_Renderer is destroyed.
+  void Destroy();
+
+  // Draws lines of text (upper case, digits and .:/%-()=) from the top-left
+  // corner at an integer pixel scale, returns the covered rectangle.
+  SDL_Rect DrawLines(SDL_Renderer* sdl_renderer, const std::vector<std::string>& lines,
+                     int x, int y, int scale, SDL_Color color);
+
+  static SDL_Rect Measure(const std::vector<std::string>& lines, int scale);
+
+ private:
+  static constexpr int kGlyphWidth = 5;
+  static constexpr int kGlyphHeight = 7;
+  static constexpr int kCellWidth = kGlyphWidth + 1;   // one texel of padding
+  static constexpr int kCellHeight = kGlyphHeight + 1;
+
+  SDL_Texture* texture_{nullptr};
+  std::array<int, 128> glyph_index_{};                  // -1 when not in the font
+  int atlas_width_{0};
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  std::vector<SDL_Vertex> vertices_;                    // reused between frames
+  std::vector<int> indices_;
+#endif
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "level.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Level::~Level() { Unmap(); }
+
+//File I/O Operations
+bool Level::Load(const std::string& file_name)
+{
+  Unmap();
+
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "Could not open level file: " << file_name << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(LevelHeader)) {
+    std::cerr << "Level file is too small: " << file_name << "\n";
+    close(fd);
+    return false;
+  }
+
+  std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::cerr << "Could not map level file: " << file_name << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+
+  LevelHeader header;
+  std::memcpy(&header, mapping, sizeof(header));
+  const std::size_t cells = static_cast<std::size_t>(header.width) * header.height;
+  const std::size_t bitmap_size = (cells + 7) / 8;
+
+  if (std::memcmp(header.magic, "SNKL", 4) != 0 || header.version != 1 ||
+      header.width == 0 || header.height == 0 || size < sizeof(LevelHeader) + bitmap_size) {
+    std::cerr << "Invalid level file: " << file_name << "\n";
+    munmap(mapping, size);
+    return false;
+  }
+
+  mapping_ = mapping;
+  mapping_size_ = size;
+  walls_ = static_cast<const std::uint8_t*>(mapping) + sizeof(LevelHeader);
+  width_ = header.width;
+  height_ = header.height;
+
+  // Count walls a byte at a time, padding bits past the last cell are masked.
+  wall_count_ = 0;
+  for (std::size_t i = 0; i < bitmap_size; ++i) {
+    unsigned bits = walls_[i];
+    if (i == bitmap_size - 1 && cells % 8 != 0) bits &= (1u << (cells % 8)) - 1;
+    wall_count_ += static_cast<std::size_t>(__builtin_popcount(bits));
+  }
+
+  if (wall_count_ == cells) {
+    std::cerr << "Level has no free cells: " << file_name << "\n";
+    Unmap();
+    return false;
+  }
+  // The snake always starts in the centre cell
+  if (IsWall(static_cast<int>(width_ / 2), static_cast<int>(height_ / 2))) {
+    std::cerr << "Level has a wall on the snake's spawn cell: " << file_name << "\n";
+    Unmap();
+    return false;
+  }
+  return true;
+}
+
+void Level::Unmap()
+{
+  if (mapping_ != nullptr) munmap(mapping_, mapping_size_);
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  walls_ = nullptr;
+  width_ = 0;
+  height_ = 0;
+  wall_count_ = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Level file layout (little endian):
+//
+//   char          magic[4]      "SNKL"
+//   std::uint32_t version       1
+//   std::uint32_t width         grid cells
+//   std::uint32_t height        grid cells
+//   std::uint8_t  walls[]       width * height bits, row major, LSB first
+//
+// The file is memory-mapped and the wall bitmap is used in place as the
+// collision grid, so loading does not depend on the map size.
+struct LevelHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t width;
+  std::uint32_t height;
+};
+
+class Level {
+ public:
+  Level() = default;
+  ~Level();
+
+  //Rule of 5 Implementation
+  Level(const Level& other) = delete;
+  Level& operator=(const Level& other) = delete;
+  Level(Level&& other) noexcept = delete;
+  Level& operator=(Level&& other) noexcept = delete;
+
+  bool Load(const std::string& file_name);
+  bool IsLoaded() const { return walls_ != nullptr; }
+
+  bool IsWall(int x, int y) const {
+    if (walls_ == nullptr) return false;
+    std::size_t cell = static_cast<std::size_t>(y) * width_ + static_cast<std::size_t>(x);
+    return (walls_[cell >> 3] >> (cell & 7)) & 1;
+  }
+
+  std::size_t GetWidth() const { return width_; }
+  std::size_t GetHeight() const { return height_; }
+  std::size_t GetWallCount() const { return wall_count_; }
+
+ private:
+  void Unmap();
+
+  void* mapping_{nullptr};
+  std::size_t mapping_size_{0};
+  const std::uint8_t* walls_{nullptr};
+  std::size_t width_{0};
+  std::size_t height_{0};
+  std::size_t wall_count_{0};
+};
+
+#endif
@@ -1,30 +1,170 @@
+#include <cmath>
 #include <iostream>
+#include <memory>
+#include <string>
 #include "controller.h"
 #include "game.h"
+#include "level.h"
 #include "renderer.h"
+#include "rl_server.h"
+#include "score_database.h"
+#include "trace.h"
 
-int main() {
+// Soak mode: the bot plays back to back games without a window until the
+// configured duration is over, then the monitor reports any upward trends.
+int RunSoak(GameSettings& game_settings, const SoakSettings& soak_settings, const Level& level,
+            ScoreDatabase& scores) {
+  if (SDL_Init(SDL_INIT_TIMER) < 0) {
+    std::cerr << "SDL could not initialize.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    return 1;
+  }
+
+  SoakMonitor monitor(soak_settings);
+  BotController bot(static_cast<int>(game_settings.grid_width),
+                    static_cast<int>(game_settings.grid_height));
+
+  while (!monitor.IsFinished()) {
+    auto game = std::make_unique<Game>(game_settings.grid_width, game_settings.grid_height, &level);
+    game->RunHeadless(bot, monitor);
+    scores.Record(game_settings.grid_width, game_settings.grid_height,
+                  game->GetScore(), game->GetSize());
+  }
+
+  bool passed = monitor.Report(std::cout);
+  SDL_Quit();
+  return passed ? 0 : 2;
+}
+
+// RL server mode: steps num_envs games on behalf of trainer processes that
+// share observations through POSIX shared memory.
+int RunRlServer(GameSettings& game_settings, const std::string& shm_name, std::size_t num_envs,
+                const Level& level) {
+  if (SDL_Init(SDL_INIT_TIMER) < 0) {
+    std::cerr << "SDL could not initialize.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    return 1;
+  }
+
+  int result = 1;
+  {
+    RlServer server(shm_name, num_envs, game_settings.grid_width, game_settings.grid_height, &level);
+    if (server.IsOpen()) {
+      std::cout << "Serving " << num_envs << " environments on " << shm_name << "\n";
+      server.Serve();
+      result = 0;
+    }
+  }
+  SDL_Quit();
+  return result;
+}
+
+int main(int argc, char* argv[]) {
 
   GameConfig config("../src/snake_config.txt");
   auto game_settings = config.GetGameSettings();
 
+  // --soak <hours> [--soak-interval <seconds>] [--soak-threshold <percent>]
+  // --rl-server <shm name> [--rl-envs <count>]
+  bool soak_mode = false;
+  std::string rl_shm_name;
+  std::size_t rl_envs = 1;
+  SoakSettings soak_settings{1.0, 60, 10.0};
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string option{argv[i]};
+    std::string value{argv[i + 1]};
+    std::size_t parsed = value.size();
+    bool valid = true;
+    try {
+      if (option == "--soak") {
+        soak_mode = true;
+        soak_settings.duration_hours = std::stod(value, &parsed);
+        valid = std::isfinite(soak_settings.duration_hours) && soak_settings.duration_hours > 0;
+      } else if (option == "--soak-interval") {
+        long long seconds = std::stoll(value, &parsed);
+        valid = seconds > 0;
+        soak_settings.sample_interval_seconds = static_cast<std::size_t>(seconds);
+      } else if (option == "--soak-threshold") {
+        soak_settings.threshold_percent = std::stod(value, &parsed);
+        valid = std::isfinite(soak_settings.threshold_percent) && soak_settings.threshold_percent >= 0;
+      } else if (option == "--rl-server") {
+        rl_shm_name = value;
+      } else if (option == "--rl-envs") {
+        long long envs = std::stoll(value, &parsed);
+        valid = envs > 0;
+        rl_envs = static_cast<std::size_t>(envs);
+      }
+    } catch (const std::exception&) {
+      valid = false;  // not a number or out of range
+    }
+    if (!valid || parsed != value.size()) {
+      std::cerr << "Invalid value '" << value << "' for " << option << "\n"
+                << "Usage: " << argv[0] << " [--soak <hours> [--soak-interval <seconds>]"
+                << " [--soak-threshold <percent>]] [--rl-server <shm name> [--rl-envs <count>]]\n"
+                << "Hours, seconds and counts must be positive, the threshold non-negative.\n";
+      return 1;
+    }
+  }
+
+  // A level map replaces the configured grid size with its own
+  Level level;
+  if (!config.GetLevelFile().empty() && level.Load(config.GetLevelFile())) {
+    game_settings.grid_width = level.GetWidth();
+    game_settings.grid_height = level.GetHeight();
+  }
+
+  ScoreDatabase scores(config.GetScoreDatabase());
+  if (scores.Count(game_settings.grid_width, game_settings.grid_height) == 0 &&
+      config.GetLegacyHighScore() > 0) {
+    // Carry the old single HighestScore line over into the database
+    scores.Record(game_settings.grid_width, game_settings.grid_height,
+                  config.GetLegacyHighScore(), 0);
+  }
+
+  // Opt-in Chrome trace-event output, see TraceFile in snake_config.txt
+  if (!config.GetTraceFile().empty() && Tracer::Instance().Start(config.GetTraceFile())) {
+    Tracer::Instance().RegisterThread("GameLoop");
+  }
+
+  if (soak_mode) {
+    int result = RunSoak(game_settings, soak_settings, level, scores);
+    Tracer::Instance().Stop();
+    return result;
+  }
+
+  if (!rl_shm_name.empty()) {
+    int result = RunRlServer(game_settings, rl_shm_name, rl_envs, level);
+    Tracer::Instance().Stop();
+    return result;
+  }
+
   Renderer renderer(game_settings.screen_width,
                     game_settings.screen_height, 
                     game_settings.grid_width, 
                     game_settings.grid_height);
+  // Walls that are not drawn would still kill the snake, so do not play blind
+  if (!renderer.SetLevel(level)) {
+    Tracer::Instance().Stop();
+    return 1;
+  }
 
   Controller controller;
 
-  Game game(game_settings.grid_width, game_settings.grid_height);
+  Game game(game_settings.grid_width, game_settings.grid_height, &level);
   game.Run(controller, renderer, game_settings.ms_per_frame);
 
+  Tracer::Instance().Stop();
   std::cout << "Game has terminated successfully!\n";
 
-  if(config.GetHighestScore() < game.GetScore())
+  if(scores.GetHighestScore(game_settings.grid_width, game_settings.grid_height) < game.GetScore())
   {
     std::cout << "Congrats, a New Score Has been achieved.!\n";
-    config.SetNewHighScore(game.GetScore());
   }
+  std::cout << "Better than "
+            << scores.PercentBelow(game_settings.grid_width, game_settings.grid_height, game.GetScore())
+            << "% of previous games\n";
+  scores.Record(game_settings.grid_width, game_settings.grid_height,
+                game.GetScore(), game.GetSize());
 
   std::cout << "Score: " << game.GetScore() << "\n";
   std::cout << "Size: " << game.GetSize() << "\n";
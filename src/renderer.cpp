@@ -1,11 +1,16 @@
 #include "renderer.h"
+#include <cstdio>
 #include <iostream>
 #include <string>
 
 Renderer::Renderer(const std::size_t& screen_width,
                    const std::size_t& screen_height,
                    const std::size_t& grid_width, const std::size_t& grid_height)
-    : screen_width(screen_width),
+    : sdl_background(nullptr),
+      hud_atlas{},
+      hud_visible{false},
+      hud_stats{},
+      screen_width(screen_width),
       screen_height(screen_height),
       grid_width(grid_width),
       grid_height(grid_height) {
@@ -30,11 +35,17 @@ Renderer::Renderer(const std::size_t& screen_width,
   if (nullptr == sdl_renderer) {
     std::cerr << "Renderer could not be created.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+  } else {
+    // The overlay font is rasterised once, not per frame
+    hud_atlas.Build(sdl_renderer);
   }
 }
 
 //Destructor Implementation
 Renderer::~Renderer() {
+  if (sdl_background != nullptr) SDL_DestroyTexture(sdl_background);
+  hud_atlas.Destroy();
+  SDL_DestroyRenderer(sdl_renderer);
   SDL_DestroyWindow(sdl_window);
   SDL_Quit();
 }
@@ -52,6 +63,12 @@ void Renderer::Render(Snake const& snake,
   SDL_SetRenderDrawColor(sdl_renderer, 0x1E, 0x1E, 0x1E, 0xFF);
   SDL_RenderClear(sdl_renderer);
 
+  // Render static walls from the cached background
+  if (sdl_background != nullptr) {
+    SDL_Rect board{0, 0, static_cast<int>(grid_width) * block.w, static_cast<int>(grid_height) * block.h};
+    SDL_RenderCopy(sdl_renderer, sdl_background, nullptr, &board);
+  }
+
   // Render food
   SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xCC, 0x00, 0xFF);
   block.x = food.x * block.w;
@@ -85,11 +102,108 @@ void Renderer::Render(Snake const& snake,
   }
   SDL_RenderFillRect(sdl_renderer, &block);
 
+  if (hud_visible) {
+    RenderHud();
+  }
+
   // Update Screen
   SDL_RenderPresent(sdl_renderer);
 }
 
+// One texel per grid cell, scaled up with nearest filtering when drawn. A
+// static texture survives device resets, unlike a render target.
+bool Renderer::SetLevel(const Level& level) {
+  if (sdl_background != nullptr) {
+    SDL_DestroyTexture(sdl_background);
+    sdl_background = nullptr;
+  }
+  if (!level.IsLoaded()) return true;
+
+  // Every cell needs at least one pixel, larger maps are for the headless modes
+  if (level.GetWidth() > screen_width || level.GetHeight() > screen_height) {
+    std::cerr << "Level of " << level.GetWidth() << "x" << level.GetHeight()
+              << " cells does not fit the " << screen_width << "x" << screen_height
+              << " window, raise ScreenWidth/ScreenHeight or use a smaller level.\n";
+    return false;
+  }
+  if (level.GetWallCount() == 0) return true;
+
+  SDL_RendererInfo info{};
+  if (SDL_GetRendererInfo(sdl_renderer, &info) == 0 &&
+      ((info.max_texture_width > 0 && level.GetWidth() > static_cast<std::size_t>(info.max_texture_width)) ||
+       (info.max_texture_height > 0 && level.GetHeight() > static_cast<std::size_t>(info.max_texture_height)))) {
+    std::cerr << "Level of " << level.GetWidth() << "x" << level.GetHeight()
+              << " cells exceeds the renderer's maximum texture size of "
+              << info.max_texture_width << "x" << info.max_texture_height << ".\n";
+    return false;
+  }
+
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+  sdl_background = SDL_CreateTexture(sdl_renderer, SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_STATIC,
+                                     static_cast<int>(level.GetWidth()),
+                                     static_cast<int>(level.GetHeight()));
+  if (nullptr == sdl_background) {
+    std::cerr << "Level texture could not be created.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    return false;
+  }
+
+  std::vector<Uint32> pixels(level.GetWidth() * level.GetHeight());
+  for (std::size_t y = 0; y < level.GetHeight(); ++y) {
+    for (std::size_t x = 0; x < level.GetWidth(); ++x) {
+      bool wall = level.IsWall(static_cast<int>(x), static_cast<int>(y));
+      pixels[y * level.GetWidth() + x] = wall ? 0xFF5A5A5A : 0xFF1E1E1E;
+    }
+  }
+  SDL_UpdateTexture(sdl_background, nullptr, pixels.data(),
+                    static_cast<int>(level.GetWidth() * sizeof(Uint32)));
+  return true;
+}
+
+void Renderer::SetHudVisible(bool visible) {
+  hud_visible = visible;
+}
+
+void Renderer::SetHudStats(const HudStats& stats) {
+  hud_stats = stats;
+}
+
+void Renderer::RenderHud() {
+  char buffer[64];
+  std::vector<std::string> lines;
+
+  std::snprintf(buffer, sizeof(buffer), "FRAME P50 %.1fMS P99 %.1fMS",
+                hud_stats.frame_p50_ms, hud_stats.frame_p99_ms);
+  lines.emplace_back(buffer);
+  std::snprintf(buffer, sizeof(buffer), "UPDATE %.2fMS RENDER %.2fMS",
+                hud_stats.update_ms, hud_stats.render_ms);
+  lines.emplace_back(buffer);
+  std::snprintf(buffer, sizeof(buffer), "LENGTH %d FREE %d",
+                hud_stats.snake_length, hud_stats.free_cells);
+  lines.emplace_back(buffer);
+  lines.emplace_back(hud_stats.snake_poisoned ? "POISON: SLOWED"
+                     : hud_stats.poison_food_active ? "POISON: ON BOARD" : "POISON: NONE");
+
+  // Translucent panel behind the text
+  const int scale = 2;
+  const int margin = 6;
+  SDL_Rect panel = GlyphAtlas::Measure(lines, scale);
+  panel.w += 2 * margin;
+  panel.h += 2 * margin;
+  SDL_SetRenderDrawBlendMode(sdl_renderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0x00, 0x00, 0xA0);
+  SDL_RenderFillRect(sdl_renderer, &panel);
+
+  hud_atlas.DrawLines(sdl_renderer, lines, margin, margin, scale, SDL_Color{0xE0, 0xE0, 0xE0, 0xFF});
+}
+
 void Renderer::UpdateWindowTitle(int& score, int& fps) {
   std::string title{"Snake Score: " + std::to_string(score) + " FPS: " + std::to_string(fps)};
   SDL_SetWindowTitle(sdl_window, title.c_str());
 }
+
+void Renderer::UpdateWindowTitle(int& score, const std::string& status) {
+  std::string title{"Snake Score: " + std::to_string(score) + " " + status};
+  SDL_SetWindowTitle(sdl_window, title.c_str());
+}
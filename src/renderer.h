@@ -3,8 +3,11 @@
 
 #include <vector>
 #include "SDL.h"
+#include "hud.h"
+#include "level.h"
 #include "snake.h"
 #include <memory>
+#include <string>
 class Renderer {
  public:
   Renderer(const std::size_t& screen_width, const std::size_t& screen_height,
@@ -20,11 +23,24 @@ class Renderer {
                 SDL_Point const& food,
                 SDL_Point const& poison_food,
                 bool is_poison_food_active);
+  // Bakes the level walls into a cached background texture, false when the
+  // level cannot be shown on this screen or renderer.
+  bool SetLevel(const Level& level);
+  // Performance overlay drawn on top of the next rendered frames
+  void SetHudVisible(bool visible);
+  void SetHudStats(const HudStats& stats);
   void UpdateWindowTitle(int& score, int& fps);
+  void UpdateWindowTitle(int& score, const std::string& status);
 
  private:
+  void RenderHud();
+
   SDL_Window* sdl_window;
   SDL_Renderer* sdl_renderer;
+  SDL_Texture* sdl_background;
+  GlyphAtlas hud_atlas;
+  bool hud_visible;
+  HudStats hud_stats;
 
   const std::size_t screen_width;
   const std::size_t screen_height;
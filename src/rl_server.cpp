@@ -0,0 +1,179 @@
+#include "rl_server.h"
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futex words must be plain 32-bit integers");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+              "shared memory atomics must be lock free");
+
+// Futexes are used without FUTEX_PRIVATE_FLAG because the word is shared
+// with another process. Elsewhere fall back to a short sleep.
+void FutexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected, long timeout_ms) {
+#ifdef __linux__
+  timespec timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000000};
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected,
+          &timeout, nullptr, 0);
+#else
+  if (word.load(std::memory_order_acquire) == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+#endif
+}
+
+void FutexWakeAll(std::atomic<std::uint32_t>& word) {
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
+std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+RlServer::RlServer(const std::string& shm_name, std::size_t num_envs,
+                   std::size_t grid_width, std::size_t grid_height, const Level* level)
+    : shm_name_(shm_name),
+      num_envs_(num_envs),
+      grid_width_(grid_width),
+      grid_height_(grid_height),
+      level_(level),
+      mapping_size_{},
+      mapping_{nullptr},
+      header_{nullptr},
+      envs_{}
+{
+  const std::size_t slots_offset = AlignUp(sizeof(RlShmHeader), 64);
+  const std::size_t observations_offset = AlignUp(slots_offset + num_envs * sizeof(RlEnvSlot), 64);
+  const std::size_t observation_stride =
+      AlignUp(Game::kObservationChannels * grid_width * grid_height, 64);
+  mapping_size_ = observations_offset + num_envs * observation_stride;
+
+  int fd = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0) {
+    std::cerr << "Could not open shared memory " << shm_name_ << ": " << std::strerror(errno) << "\n";
+    return;
+  }
+  if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+    std::cerr << "Could not size shared memory " << shm_name_ << ": " << std::strerror(errno) << "\n";
+    close(fd);
+    return;
+  }
+  void* mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::cerr << "Could not map shared memory " << shm_name_ << ": " << std::strerror(errno) << "\n";
+    return;
+  }
+  mapping_ = mapping;
+
+  header_ = new (mapping_) RlShmHeader();
+  header_->version = kRlShmVersion;
+  header_->num_envs = static_cast<std::uint32_t>(num_envs);
+  header_->grid_width = static_cast<std::uint32_t>(grid_width);
+  header_->grid_height = static_cast<std::uint32_t>(grid_height);
+  header_->channels = Game::kObservationChannels;
+  header_->slots_offset = slots_offset;
+  header_->observations_offset = observations_offset;
+  header_->observation_stride = observation_stride;
+
+  envs_.resize(num_envs);
+  for (std::size_t env = 0; env < num_envs; ++env) {
+    new (&Slot(env)) RlEnvSlot();
+    ResetEnv(env);
+  }
+
+  // Publish last so a trainer polling the magic sees a fully built mapping.
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = kRlShmMagic;
+}
+
+RlServer::~RlServer() {
+  envs_.clear();
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+    shm_unlink(shm_name_.c_str());
+  }
+}
+
+bool RlServer::IsOpen() const { return header_ != nullptr; }
+
+void RlServer::Serve() {
+  if (!IsOpen()) return;
+
+  std::uint32_t served = header_->request_seq.load(std::memory_order_acquire);
+  while (header_->shutdown.load(std::memory_order_acquire) == 0) {
+    std::uint32_t request = header_->request_seq.load(std::memory_order_acquire);
+    if (request == served) {
+      FutexWait(header_->request_seq, served, 100);
+      continue;
+    }
+
+    for (std::size_t env = 0; env < num_envs_; ++env) {
+      if (Slot(env).pending.exchange(0, std::memory_order_acq_rel) != 0) {
+        StepEnv(env);
+      }
+    }
+
+    served = request;
+    header_->completion_seq.store(served, std::memory_order_release);
+    FutexWakeAll(header_->completion_seq);
+  }
+}
+
+void RlServer::ResetEnv(std::size_t env) {
+  envs_[env].reset();  // join the old poison worker before starting a new game
+  envs_[env] = std::make_unique<Game>(grid_width_, grid_height_, level_);
+
+  RlEnvSlot& slot = Slot(env);
+  slot.reward = 0.0f;
+  slot.done = 0;
+  slot.score = 0;
+  slot.steps = 0;
+  envs_[env]->WriteStaticObservation(Observation(env));
+  envs_[env]->WriteObservation(Observation(env));
+}
+
+void RlServer::StepEnv(std::size_t env) {
+  RlEnvSlot& slot = Slot(env);
+  if (slot.action == kRlActionReset) {
+    ResetEnv(env);
+    return;
+  }
+
+  Game::StepResult result = envs_[env]->Step(slot.action);
+  slot.reward = result.reward;
+  slot.done = result.done ? 1 : 0;
+  slot.score = envs_[env]->GetScore();
+  slot.steps++;
+  envs_[env]->WriteObservation(Observation(env));
+}
+
+RlEnvSlot& RlServer::Slot(std::size_t env) {
+  auto* base = static_cast<std::uint8_t*>(mapping_) + header_->slots_offset;
+  return reinterpret_cast<RlEnvSlot*>(base)[env];
+}
+
+std::uint8_t* RlServer::Observation(std::size_t env) {
+  return static_cast<std::uint8_t*>(mapping_) + header_->observations_offset +
+         env * header_->observation_stride;
+}
@@ -0,0 +1,87 @@
+#ifndef RL_SERVER_H
+#define RL_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "game.h"
+
+// Shared memory layout (all offsets from the start of the mapping):
+//
+//   RlShmHeader                          at 0
+//   RlEnvSlot[num_envs]                  at slots_offset
+//   uint8 observations[num_envs][channels][grid_height][grid_width]
+//                                        at observations_offset
+//
+// A trainer posts actions by writing RlEnvSlot::action and setting pending
+// to 1 for each env it wants to step, then increments request_seq and
+// futex-wakes it. The server steps every pending env, writes the reward,
+// done flag and observation in place, stores request_seq into
+// completion_seq and futex-wakes that word. Observations are never copied:
+// the server renders them straight into the mapping.
+struct RlShmHeader {
+  std::uint32_t magic;                      // kRlShmMagic once initialised
+  std::uint32_t version;
+  std::uint32_t num_envs;
+  std::uint32_t grid_width;
+  std::uint32_t grid_height;
+  std::uint32_t channels;
+  std::uint64_t slots_offset;
+  std::uint64_t observations_offset;
+  std::uint64_t observation_stride;         // bytes per env
+  std::atomic<std::uint32_t> request_seq;
+  std::atomic<std::uint32_t> completion_seq;
+  std::atomic<std::uint32_t> shutdown;      // trainer sets to stop the server
+};
+
+struct RlEnvSlot {
+  std::atomic<std::uint32_t> pending;
+  std::int32_t action;                      // 0-3 direction, 4 keep, -1 reset
+  float reward;
+  std::uint32_t done;
+  std::int32_t score;
+  std::uint32_t steps;
+};
+
+constexpr std::uint32_t kRlShmMagic = 0x4C524E53;  // "SNRL"
+constexpr std::uint32_t kRlShmVersion = 2;  // 2 added the walls channel
+constexpr std::int32_t kRlActionReset = -1;
+
+// Serves num_envs independent games to local trainer processes through a
+// POSIX shared memory object. All games share the optional level map.
+class RlServer {
+ public:
+  RlServer(const std::string& shm_name, std::size_t num_envs,
+           std::size_t grid_width, std::size_t grid_height, const Level* level = nullptr);
+  ~RlServer();
+
+  //Rule of 5 Implementation
+  RlServer(const RlServer& other) = delete;
+  RlServer& operator=(const RlServer& other) = delete;
+  RlServer(RlServer&& other) noexcept = delete;
+  RlServer& operator=(RlServer&& other) noexcept = delete;
+
+  bool IsOpen() const;
+  // Blocks serving step requests until the trainer sets shutdown.
+  void Serve();
+
+ private:
+  void ResetEnv(std::size_t env);
+  void StepEnv(std::size_t env);
+  RlEnvSlot& Slot(std::size_t env);
+  std::uint8_t* Observation(std::size_t env);
+
+  std::string shm_name_;
+  std::size_t num_envs_;
+  std::size_t grid_width_;
+  std::size_t grid_height_;
+  const Level* level_;
+  std::size_t mapping_size_;
+  void* mapping_;
+  RlShmHeader* header_;
+  std::vector<std::unique_ptr<Game>> envs_;
+};
+
+#endif
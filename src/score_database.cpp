@@ -0,0 +1,375 @@
+#include "score_database.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct IndexHeader {
+  char magic[4];               // "SNKS"
+  std::uint32_t version;
+  std::uint64_t record_count;
+  std::uint64_t last_sequence;
+  std::uint32_t checksum;      // FNV-1a over all records
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(ScoreRecord) == 40, "ScoreRecord is an on-disk format");
+static_assert(sizeof(IndexHeader) == 32, "IndexHeader is an on-disk format");
+
+bool WriteAll(int fd, const void* data, std::size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+bool ReadAll(int fd, void* data, std::size_t size) {
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t got = read(fd, bytes, size);
+    if (got < 0 && errno == EINTR) continue;
+    if (got <= 0) return false;
+    bytes += got;
+    size -= static_cast<std::size_t>(got);
+  }
+  return true;
+}
+
+// The rename itself is only durable once the directory entry is synced.
+void SyncParentDirectory(const std::string& path) {
+  std::string::size_type slash = path.find_last_of('/');
+  std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+  int fd = open(directory.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+}
+
+}  // namespace
+
+ScoreDatabase::ScoreDatabase(const std::string& base_path)
+    : index_path_(base_path + ".idx"),
+      log_path_(base_path + ".log"),
+      log_fd_{-1},
+      appended_since_compaction_{0},
+      mutex_{},
+      grids_{},
+      next_sequence_{1},
+      index_sequence_{0},
+      pending_{},
+      writer_cv_{},
+      stop_writer_{false},
+      writer_thread_{}
+{
+  LoadIndex();
+  ReplayLog();
+
+  log_fd_ = open(log_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (log_fd_ < 0) {
+    std::cerr << "Could not open score log " << log_path_ << ": " << std::strerror(errno) << "\n";
+  }
+  writer_thread_ = std::thread(&ScoreDatabase::WriterLoop, this);
+}
+
+ScoreDatabase::~ScoreDatabase() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_writer_ = true;
+  }
+  writer_cv_.notify_all();
+  if (writer_thread_.joinable()) writer_thread_.join();
+  if (log_fd_ >= 0) close(log_fd_);
+}
+
+void ScoreDatabase::Record(std::size_t grid_width, std::size_t grid_height, int score, int size) {
+  ScoreRecord record{};
+  record.timestamp = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+  record.grid_width = static_cast<std::uint32_t>(grid_width);
+  record.grid_height = static_cast<std::uint32_t>(grid_height);
+  record.score = score;
+  record.size = size;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    record.sequence = next_sequence_++;
+    record.checksum = RecordChecksum(record);
+    Insert(record);
+    pending_.push_back(record);
+  }
+  writer_cv_.notify_one();
+}
+
+std::size_t ScoreDatabase::Count(std::size_t grid_width, std::size_t grid_height) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const GridScores* scores = FindGrid(grid_width, grid_height);
+  return scores == nullptr ? 0 : scores->records.size();
+}
+
+int ScoreDatabase::GetHighestScore(std::size_t grid_width, std::size_t grid_height) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const GridScores* scores = FindGrid(grid_width, grid_height);
+  if (scores == nullptr || scores->records.empty()) return 0;
+  return scores->records.rbegin()->first.first;
+}
+
+std::vector<ScoreRecord> ScoreDatabase::TopScores(std::size_t grid_width, std::size_t grid_height,
+                                                  std::size_t count) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ScoreRecord> top;
+  const GridScores* scores = FindGrid(grid_width, grid_height);
+  if (scores == nullptr) return top;
+
+  top.reserve(std::min(count, scores->records.size()));
+  for (auto it = scores->records.rbegin(); it != scores->records.rend() && top.size() < count; ++it) {
+    top.push_back(it->second);
+  }
+  return top;
+}
+
+int ScoreDatabase::Percentile(std::size_t grid_width, std::size_t grid_height, double percentile) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const GridScores* scores = FindGrid(grid_width, grid_height);
+  if (scores == nullptr || scores->records.empty()) return 0;
+
+  const std::size_t size = scores->records.size();
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  std::size_t rank = static_cast<std::size_t>(std::ceil(percentile / 100.0 * size));
+  rank = std::clamp<std::size_t>(rank, 1, size);
+  return scores->FindByOrder(rank - 1);
+}
+
+double ScoreDatabase::PercentBelow(std::size_t grid_width, std::size_t grid_height, int score) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const GridScores* scores = FindGrid(grid_width, grid_height);
+  if (scores == nullptr || scores->records.empty()) return 0.0;
+  std::size_t below = scores->CountBelow(score);
+  return 100.0 * static_cast<double>(below) / static_cast<double>(scores->records.size());
+}
+
+std::uint64_t ScoreDatabase::GridKey(std::size_t grid_width, std::size_t grid_height) {
+  return (static_cast<std::uint64_t>(grid_width) << 32) | static_cast<std::uint32_t>(grid_height);
+}
+
+std::uint32_t ScoreDatabase::Checksum(const void* data, std::size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+std::uint32_t ScoreDatabase::RecordChecksum(const ScoreRecord& record) {
+  return Checksum(&record, offsetof(ScoreRecord, checksum));
+}
+
+const ScoreDatabase::GridScores* ScoreDatabase::FindGrid(std::size_t grid_width,
+                                                         std::size_t grid_height) const {
+  auto it = grids_.find(GridKey(grid_width, grid_height));
+  return it == grids_.end() ? nullptr : &it->second;
+}
+
+void ScoreDatabase::Insert(const ScoreRecord& record) {
+  GridScores& scores = grids_[GridKey(record.grid_width, record.grid_height)];
+  if (scores.records.emplace(ScoreKey{record.score, record.sequence}, record).second) {
+    scores.Add(record.score);
+  }
+  next_sequence_ = std::max(next_sequence_, record.sequence + 1);
+}
+
+void ScoreDatabase::GridScores::Add(std::int32_t score) {
+  const std::size_t value = static_cast<std::size_t>(std::max(score, 0));
+  if (counts.empty() || value >= counts.size() - 1) {
+    // Grow to the next power of two and rebuild from the records, which
+    // already include this score.
+    std::size_t capacity = 64;
+    while (capacity <= value) capacity *= 2;
+    counts.assign(capacity + 1, 0);
+    for (auto const& entry : records) {
+      std::size_t index = static_cast<std::size_t>(std::max(entry.first.first, 0)) + 1;
+      counts[index]++;
+    }
+    for (std::size_t i = 1; i < counts.size(); ++i) {
+      std::size_t parent = i + (i & (~i + 1));
+      if (parent < counts.size()) counts[parent] += counts[i];
+    }
+    return;
+  }
+  for (std::size_t i = value + 1; i < counts.size(); i += i & (~i + 1)) counts[i]++;
+}
+
+std::size_t ScoreDatabase::GridScores::CountBelow(std::int32_t score) const {
+  if (counts.empty() || score <= 0) return 0;
+  std::size_t total = 0;
+  for (std::size_t i = std::min<std::size_t>(static_cast<std::size_t>(score), counts.size() - 1);
+       i > 0; i -= i & (~i + 1)) {
+    total += counts[i];
+  }
+  return total;
+}
+
+// Binary lifting: the largest value whose prefix count is still <= order.
+std::int32_t ScoreDatabase::GridScores::FindByOrder(std::size_t order) const {
+  std::size_t position = 0;
+  for (std::size_t step = (counts.size() - 1); step > 0; step /= 2) {
+    if (position + step < counts.size() && counts[position + step] <= order) {
+      position += step;
+      order -= counts[position];
+    }
+  }
+  return static_cast<std::int32_t>(position);
+}
+
+//File I/O Operations
+void ScoreDatabase::LoadIndex() {
+  int fd = open(index_path_.c_str(), O_RDONLY);
+  if (fd < 0) return;  // first run
+
+  IndexHeader header{};
+  std::vector<ScoreRecord> records;
+  struct stat index_stat {};
+  bool valid = fstat(fd, &index_stat) == 0 && ReadAll(fd, &header, sizeof(header)) &&
+               std::memcmp(header.magic, "SNKS", 4) == 0 && header.version == 1;
+  // The record count must match the file size before anything is allocated
+  // from it, a garbage header must not take the game down.
+  if (valid) {
+    std::uint64_t payload = static_cast<std::uint64_t>(index_stat.st_size) - sizeof(header);
+    valid = payload % sizeof(ScoreRecord) == 0 && payload / sizeof(ScoreRecord) == header.record_count;
+  }
+  if (valid) {
+    records.resize(header.record_count);
+    valid = ReadAll(fd, records.data(), records.size() * sizeof(ScoreRecord)) &&
+            Checksum(records.data(), records.size() * sizeof(ScoreRecord)) == header.checksum &&
+            std::all_of(records.begin(), records.end(), [&header](const ScoreRecord& record) {
+              return record.sequence <= header.last_sequence;
+            });
+  }
+  close(fd);
+
+  if (!valid) {
+    // The index is only ever replaced by rename, so this is not a torn write.
+    std::cerr << "Score index " << index_path_ << " is corrupt, ignoring it\n";
+    return;
+  }
+
+  for (auto const& record : records) Insert(record);
+  index_sequence_ = header.last_sequence;
+  next_sequence_ = std::max(next_sequence_, index_sequence_ + 1);
+}
+
+void ScoreDatabase::ReplayLog() {
+  int fd = open(log_path_.c_str(), O_RDWR);
+  if (fd < 0) return;
+
+  ScoreRecord record{};
+  off_t valid_bytes = 0;
+  while (ReadAll(fd, &record, sizeof(record))) {
+    if (record.checksum != RecordChecksum(record)) break;
+    if (record.sequence > index_sequence_) Insert(record);
+    appended_since_compaction_++;  // folded into the index on the next compaction
+    valid_bytes += static_cast<off_t>(sizeof(record));
+  }
+
+  // Drop a partially written record left behind by a crash mid-append.
+  struct stat log_stat {};
+  if (fstat(fd, &log_stat) == 0 && log_stat.st_size > valid_bytes) {
+    std::cerr << "Truncating damaged tail of score log " << log_path_ << "\n";
+    if (ftruncate(fd, valid_bytes) == 0) fsync(fd);
+  }
+  close(fd);
+}
+
+void ScoreDatabase::WriterLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    writer_cv_.wait(lock, [this] { return stop_writer_ || !pending_.empty(); });
+
+    std::vector<ScoreRecord> batch;
+    batch.swap(pending_);
+    bool stopping = stop_writer_;
+    lock.unlock();
+
+    if (!batch.empty() && AppendToLog(batch)) {
+      appended_since_compaction_ += batch.size();
+    }
+    if (appended_since_compaction_ >= kCompactEvery ||
+        (stopping && appended_since_compaction_ > 0)) {
+      if (Compact()) appended_since_compaction_ = 0;
+    }
+
+    lock.lock();
+    if (stopping && pending_.empty()) return;
+  }
+}
+
+bool ScoreDatabase::AppendToLog(const std::vector<ScoreRecord>& records) {
+  if (log_fd_ < 0) return false;
+  if (!WriteAll(log_fd_, records.data(), records.size() * sizeof(ScoreRecord)) ||
+      fdatasync(log_fd_) != 0) {
+    std::cerr << "Failed to append to score log " << log_path_ << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Writes every record, sorted by grid and score, to a fresh index and swaps
+// it in atomically. Only then is the log emptied; a crash in between just
+// means the replay skips records the new index already holds.
+bool ScoreDatabase::Compact() {
+  std::vector<ScoreRecord> records;
+  IndexHeader header{};
+  std::memcpy(header.magic, "SNKS", 4);
+  header.version = 1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& grid : grids_) {
+      for (auto const& entry : grid.second.records) records.push_back(entry.second);
+    }
+    header.last_sequence = next_sequence_ - 1;
+  }
+  header.record_count = records.size();
+  header.checksum = Checksum(records.data(), records.size() * sizeof(ScoreRecord));
+
+  const std::string temp_path = index_path_ + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::cerr << "Could not write score index " << temp_path << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+  bool written = WriteAll(fd, &header, sizeof(header)) &&
+                 WriteAll(fd, records.data(), records.size() * sizeof(ScoreRecord)) &&
+                 fsync(fd) == 0;
+  close(fd);
+  if (!written || std::rename(temp_path.c_str(), index_path_.c_str()) != 0) {
+    std::cerr << "Failed to replace score index " << index_path_ << ": " << std::strerror(errno) << "\n";
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  SyncParentDirectory(index_path_);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_sequence_ = header.last_sequence;
+  }
+  if (log_fd_ >= 0 && ftruncate(log_fd_, 0) == 0) fdatasync(log_fd_);
+  return true;
+}
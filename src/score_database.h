@@ -0,0 +1,99 @@
+#ifndef SCORE_DATABASE_H
+#define SCORE_DATABASE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct ScoreRecord {
+  std::uint64_t sequence;
+  std::uint64_t timestamp;    // seconds since the epoch
+  std::uint32_t grid_width;
+  std::uint32_t grid_height;
+  std::int32_t score;
+  std::int32_t size;
+  std::uint32_t checksum;     // FNV-1a over the fields above
+  std::uint32_t reserved;
+};
+
+// Crash-safe store of every finished game, grouped by grid configuration.
+//
+// Results are appended to <base>.log by a background thread, so Record never
+// blocks on disk. Every kCompactEvery records the whole set is written sorted
+// to <base>.idx.tmp, fsync'ed and renamed over <base>.idx, then the log is
+// truncated. On load the index is read and the log replayed, skipping records
+// the index already covers and dropping a torn tail left by a crash.
+// In memory each grid configuration keeps its records ordered by score for
+// top-K queries plus a Fenwick tree of score counts, giving O(log n) insert,
+// rank and percentile queries.
+class ScoreDatabase {
+ public:
+  explicit ScoreDatabase(const std::string& base_path);
+  ~ScoreDatabase();
+
+  //Rule of 5 Implementation
+  ScoreDatabase(const ScoreDatabase& other) = delete;
+  ScoreDatabase& operator=(const ScoreDatabase& other) = delete;
+  ScoreDatabase(ScoreDatabase&& other) noexcept = delete;
+  ScoreDatabase& operator=(ScoreDatabase&& other) noexcept = delete;
+
+  void Record(std::size_t grid_width, std::size_t grid_height, int score, int size);
+
+  std::size_t Count(std::size_t grid_width, std::size_t grid_height) const;
+  int GetHighestScore(std::size_t grid_width, std::size_t grid_height) const;
+  std::vector<ScoreRecord> TopScores(std::size_t grid_width, std::size_t grid_height,
+                                     std::size_t count) const;
+  // Nearest-rank percentile (0-100) of the scores, 0 when there are none.
+  int Percentile(std::size_t grid_width, std::size_t grid_height, double percentile) const;
+  // Share of recorded games (0-100) that scored strictly below score.
+  double PercentBelow(std::size_t grid_width, std::size_t grid_height, int score) const;
+
+ private:
+  using ScoreKey = std::pair<std::int32_t, std::uint64_t>;  // score, sequence
+
+  struct GridScores {
+    std::map<ScoreKey, ScoreRecord> records;
+    // 1-based Fenwick tree over score values, size is a power of two plus one.
+    // Negative scores are counted as 0.
+    std::vector<std::uint32_t> counts;
+
+    void Add(std::int32_t score);
+    std::size_t CountBelow(std::int32_t score) const;
+    std::int32_t FindByOrder(std::size_t order) const;  // order-th lowest, 0-based
+  };
+
+  static constexpr std::size_t kCompactEvery = 1024;
+
+  static std::uint64_t GridKey(std::size_t grid_width, std::size_t grid_height);
+  static std::uint32_t Checksum(const void* data, std::size_t size);
+  static std::uint32_t RecordChecksum(const ScoreRecord& record);
+
+  const GridScores* FindGrid(std::size_t grid_width, std::size_t grid_height) const;
+  void Insert(const ScoreRecord& record);
+  void LoadIndex();
+  void ReplayLog();
+  void WriterLoop();
+  bool AppendToLog(const std::vector<ScoreRecord>& records);
+  bool Compact();
+
+  const std::string index_path_;
+  const std::string log_path_;
+  int log_fd_;                          // writer thread only
+  std::size_t appended_since_compaction_;
+
+  mutable std::mutex mutex_;            // guards everything below
+  std::map<std::uint64_t, GridScores> grids_;
+  std::uint64_t next_sequence_;
+  std::uint64_t index_sequence_;        // highest sequence covered by the index
+  std::vector<ScoreRecord> pending_;
+  std::condition_variable writer_cv_;
+  bool stop_writer_;
+  std::thread writer_thread_;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "snake.h"
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 //Constructor Implementation
 Snake::Snake(int grid_width_, int grid_height_)
@@ -10,110 +11,132 @@ Snake::Snake(int grid_width_, int grid_height_)
         size_{1},
         alive_{true},
         snake_head_position_{grid_width_ / 2.0f, grid_height_ / 2.0f},
-        direction_{Direction::kUp}
+        direction_{Direction::kUp},
+        level_{nullptr},
+        occupancy_(static_cast<std::size_t>(grid_width_) * grid_height_, 0)
         {}
 
 
-void Snake::Update() {
-  SDL_Point prev_cell{
+// Swept movement: the head walks every cell it crosses this tick, so a speed
+// above one cell per tick never skips food, body segments or walls. Each
+// step is O(1) thanks to the occupancy grid.
+void Snake::Update(const std::function<void(const SDL_Point&)>& on_enter_cell) {
+  SDL_Point cell{
       static_cast<int>(snake_head_position_.x),
-      static_cast<int>(
-          snake_head_position_.y)};  // We first capture the head's cell before updating.
-  UpdateHead();
-  SDL_Point current_cell{
-      static_cast<int>(snake_head_position_.x),
-      static_cast<int>(snake_head_position_.y)};  // Capture the head's cell after updating.
+      static_cast<int>(snake_head_position_.y)};  // We first capture the head's cell before updating.
+
+  bool vertical = direction_ == Direction::kUp || direction_ == Direction::kDown;
+  bool forward = direction_ == Direction::kDown || direction_ == Direction::kRight;
+  float &axis = vertical ? snake_head_position_.y : snake_head_position_.x;
+  int extent = vertical ? grid_height_ : grid_width_;
+
+  // Every integer boundary between the old and the unwrapped new coordinate
+  // is one cell entered.
+  float target = axis + (forward ? speed_ : -speed_);
+  int crossed = std::abs(static_cast<int>(std::floor(target)) - static_cast<int>(std::floor(axis)));
+
+  for (int i = 0; i < crossed && alive_; ++i) {
+    SDL_Point prev_cell = cell;
+    cell = NextCell(cell);
+    // Keep the head inside the cell being processed so SnakeCell stays
+    // accurate for food placed from the callback.
+    axis = (vertical ? cell.y : cell.x) + 0.5f;
+    UpdateBody(cell, prev_cell);
+    if (alive_ && on_enter_cell) on_enter_cell(cell);
+  }
 
-  // Update all of the body_ vector items if the snake head has moved to a new
-  // cell.
-  if (current_cell.x != prev_cell.x || current_cell.y != prev_cell.y) {
-    UpdateBody(current_cell, prev_cell);
+  if (alive_) {
+    axis = Wrap(target, extent);
   }
 }
 
-void Snake::UpdateHead() {
+SDL_Point Snake::NextCell(const SDL_Point &cell) const {
+  SDL_Point next = cell;
   switch (direction_) {
     case Direction::kUp:
-      snake_head_position_.y -= speed_;
+      next.y--;
       break;
 
     case Direction::kDown:
-      snake_head_position_.y += speed_;
+      next.y++;
       break;
 
     case Direction::kLeft:
-      snake_head_position_.x -= speed_;
+      next.x--;
       break;
 
     case Direction::kRight:
-      snake_head_position_.x += speed_;
+      next.x++;
       break;
   }
 
   // Wrap the Snake around to the beginning if going off of the screen.
-  snake_head_position_.x = fmod(snake_head_position_.x + grid_width_, grid_width_);
-  snake_head_position_.y = fmod(snake_head_position_.y + grid_height_, grid_height_);
+  next.x = (next.x + grid_width_) % grid_width_;
+  next.y = (next.y + grid_height_) % grid_height_;
+  return next;
+}
+
+float Snake::Wrap(float value, int extent) const {
+  float wrapped = std::fmod(value, static_cast<float>(extent));
+  if (wrapped < 0) wrapped += extent;
+  if (wrapped >= extent) wrapped = 0;  // rounding of tiny negative values
+  return wrapped;
 }
 
 void Snake::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell) {
-  // Add previous head location to vector
+  // Add previous head location to the body
   body_.push_back(prev_head_cell);
+  occupancy_[CellIndex(prev_head_cell.x, prev_head_cell.y)]++;
 
   if (!growing_) {
-    // Remove the tail from the vector.
-    body_.erase(body_.begin());
+    // Remove the tail from the body.
+    occupancy_[CellIndex(body_.front().x, body_.front().y)]--;
+    body_.pop_front();
   } else {
     growing_ = false;
     size_++;
   }
 
   // Check if the snake has died.
-  for (auto const &item : body_) {
-    if (current_head_cell.x == item.x && current_head_cell.y == item.y) {
-      alive_ = false;
-    }
+  if (level_ != nullptr && level_->IsWall(current_head_cell.x, current_head_cell.y)) {
+    alive_ = false;
+  }
+  if (occupancy_[CellIndex(current_head_cell.x, current_head_cell.y)] > 0) {
+    alive_ = false;
   }
 }
 
 void Snake::GrowBody() { growing_ = true; }
 
+std::size_t Snake::CellIndex(int x, int y) const {
+  return static_cast<std::size_t>(y) * grid_width_ + static_cast<std::size_t>(x);
+}
+
 bool Snake::SnakeCell(int x, int y) {
-  if (x == static_cast<int>(snake_head_position_.x) && y == static_cast<int>(snake_head_position_.y)) {
+  if (x < 0 || y < 0 || x >= grid_width_ || y >= grid_height_) {
+    return false;
+  }
+  if (level_ != nullptr && level_->IsWall(x, y)) {
     return true;
   }
-  for (auto const &item : body_) {
-    if (x == item.x && y == item.y) {
-      return true;
-    }
+  if (x == static_cast<int>(snake_head_position_.x) && y == static_cast<int>(snake_head_position_.y)) {
+    return true;
   }
-  return false;
+  return occupancy_[CellIndex(x, y)] > 0;
 }
 
 bool Snake::SnakeCell(Snake::Position<float> pos)
 {
-  if (pos.x == static_cast<int>(snake_head_position_.x) && pos.y == static_cast<int>(snake_head_position_.y)) 
-  {
-    return true;
-  }
-  for (auto const &item : body_) {
-    if (pos.x == item.x && pos.y == item.y) {
-      return true;
-    }
-  }
-  return false;
+  return SnakeCell(static_cast<int>(pos.x), static_cast<int>(pos.y));
 }
 
 bool Snake::SnakeCell(SDL_Point point) {
-    if (point.x == static_cast<int>(snake_head_position_.x) && 
-        point.y == static_cast<int>(snake_head_position_.y)) {
-        return true;
-    }
-    for (auto const &item : body_) {
-        if (point.x == item.x && point.y == item.y) {
-            return true;
-        }
-    }
-    return false;
+    return SnakeCell(point.x, point.y);
+}
+
+void Snake::SetLevel(const Level* level)
+{
+  level_ = level;
 }
 
 void Snake::IncreaseSpeed()
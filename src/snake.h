@@ -1,8 +1,12 @@
 #ifndef SNAKE_H
 #define SNAKE_H
 
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <vector>
 #include "SDL.h"
+#include "level.h"
 
 //Class Access Specifiers and Organization
 class Snake {
@@ -25,7 +29,8 @@ class Snake {
   Snake(Snake&& other) noexcept = delete;
   Snake& operator=(Snake&& other) noexcept = delete;
 
-  void Update();
+  // on_enter_cell runs for every cell the head enters during the tick.
+  void Update(const std::function<void(const SDL_Point&)>& on_enter_cell = nullptr);
   void GrowBody();
 
   // Overloading Functions
@@ -33,6 +38,9 @@ class Snake {
   bool SnakeCell(SDL_Point);
   bool SnakeCell(Snake::Position<float>);
 
+  // Walls of the level count as occupied cells and kill the snake.
+  void SetLevel(const Level* level);
+
   void IncreaseSpeed();
   void SetSpeed(float);
   float GetSpeed();
@@ -45,12 +53,14 @@ class Snake {
   void SetSnakeDirection (const Direction&);
 
   //Data Structures and Variables
-  std::vector<SDL_Point> body_;
+  std::deque<SDL_Point> body_;
 
 
  private:
-  void UpdateHead();
+  SDL_Point NextCell(const SDL_Point &cell) const;
+  float Wrap(float value, int extent) const;
   void UpdateBody(SDL_Point &current_cell, SDL_Point &prev_cell);
+  std::size_t CellIndex(int x, int y) const;
 
   int grid_width_;
   int grid_height_;
@@ -60,6 +70,8 @@ class Snake {
   bool alive_;
   Position<float> snake_head_position_;
   Direction direction_;
+  const Level* level_;
+  std::vector<std::uint8_t> occupancy_;  // body segments per cell, head excluded
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "soak_monitor.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+SoakMonitor::SoakMonitor(const SoakSettings& settings)
+    : settings_(settings),
+      start_(std::chrono::steady_clock::now()),
+      next_sample_(start_ + std::chrono::seconds(settings.sample_interval_seconds)),
+      end_(start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double, std::ratio<3600>>(settings.duration_hours))),
+      window_ticks_{},
+      window_min_threads_{-1},
+      samples_{},
+      games_played_{0},
+      best_score_{0}
+{
+  window_ticks_.reserve(settings.sample_interval_seconds * 1000);
+}
+
+void SoakMonitor::RecordTick(std::uint64_t tick_micros, int snake_size)
+{
+  window_ticks_.push_back(tick_micros);
+  // The poison worker comes and goes, the minimum over the interval only
+  // moves when threads are really left behind.
+  if (window_ticks_.size() % kThreadProbeEvery == 1) {
+    double threads = ReadThreadCount();
+    if (window_min_threads_ < 0 || threads < window_min_threads_) window_min_threads_ = threads;
+  }
+  if (std::chrono::steady_clock::now() >= next_sample_) {
+    TakeSample(snake_size);
+    next_sample_ += std::chrono::seconds(settings_.sample_interval_seconds);
+  }
+}
+
+void SoakMonitor::RecordGameOver(int score)
+{
+  games_played_++;
+  best_score_ = std::max(best_score_, score);
+}
+
+bool SoakMonitor::IsFinished() const
+{
+  return std::chrono::steady_clock::now() >= end_;
+}
+
+void SoakMonitor::TakeSample(int snake_size)
+{
+  Sample sample{};
+  sample.elapsed_minutes = std::chrono::duration<double, std::ratio<60>>(
+      std::chrono::steady_clock::now() - start_).count();
+  sample.rss_kib = ReadRssKib();
+  sample.thread_count = window_min_threads_ >= 0 ? window_min_threads_ : ReadThreadCount();
+  sample.snake_size = snake_size;
+
+  if (!window_ticks_.empty()) {
+    auto percentile = [this](double fraction) {
+      auto nth = window_ticks_.begin() + static_cast<std::ptrdiff_t>(fraction * (window_ticks_.size() - 1));
+      std::nth_element(window_ticks_.begin(), nth, window_ticks_.end());
+      return static_cast<double>(*nth);
+    };
+    sample.tick_p50_us = percentile(0.50);
+    sample.tick_p99_us = percentile(0.99);
+  }
+  window_ticks_.clear();
+  window_min_threads_ = -1;
+  samples_.push_back(sample);
+
+  std::cout << "[soak] t=" << sample.elapsed_minutes << "min"
+            << " rss=" << sample.rss_kib << "KiB"
+            << " threads=" << sample.thread_count
+            << " tick_p50=" << sample.tick_p50_us << "us"
+            << " tick_p99=" << sample.tick_p99_us << "us"
+            << " size=" << sample.snake_size
+            << " games=" << games_played_ << "\n";
+}
+
+// Fits a least-squares line through the samples and compares the growth it
+// predicts over the whole run against the fitted starting value.
+bool SoakMonitor::CheckTrend(std::ostream& out, const char* metric, double Sample::*field,
+                             double noise_floor) const
+{
+  const double n = static_cast<double>(samples_.size());
+  double sum_t = 0, sum_v = 0, sum_tt = 0, sum_tv = 0;
+  for (auto const& sample : samples_) {
+    sum_t += sample.elapsed_minutes;
+    sum_v += sample.*field;
+    sum_tt += sample.elapsed_minutes * sample.elapsed_minutes;
+    sum_tv += sample.elapsed_minutes * sample.*field;
+  }
+
+  const double denominator = n * sum_tt - sum_t * sum_t;
+  const double slope = denominator != 0 ? (n * sum_tv - sum_t * sum_v) / denominator : 0;
+  const double first_t = samples_.front().elapsed_minutes;
+  const double last_t = samples_.back().elapsed_minutes;
+  const double baseline = (sum_v - slope * sum_t) / n + slope * first_t;
+  const double growth = slope * (last_t - first_t);
+  const double growth_percent = baseline > 0 ? 100.0 * growth / baseline : 0;
+  const bool passed = growth_percent <= settings_.threshold_percent || growth <= noise_floor;
+
+  out << "  " << metric << ": start " << baseline << ", trend " << slope << "/min, "
+      << growth_percent << "% over run " << (passed ? "[ok]" : "[REGRESSION]") << "\n";
+  return passed;
+}
+
+bool SoakMonitor::Report(std::ostream& out) const
+{
+  out << "Soak report: " << samples_.size() << " samples, " << games_played_
+      << " games, best score " << best_score_ << "\n";
+
+  if (samples_.size() < 3) {
+    out << "  Not enough samples to detect a trend\n";
+    return true;
+  }
+
+  bool passed = true;
+  passed &= CheckTrend(out, "RSS KiB", &Sample::rss_kib, 1024.0);
+  passed &= CheckTrend(out, "Threads", &Sample::thread_count, 1.0);
+  passed &= CheckTrend(out, "Tick p50 us", &Sample::tick_p50_us, 25.0);
+  passed &= CheckTrend(out, "Tick p99 us", &Sample::tick_p99_us, 100.0);
+
+  if (passed) {
+    out << "Soak passed\n";
+  } else {
+    out << "Soak FAILED: a metric grew more than " << settings_.threshold_percent
+        << "% and beyond its noise floor\n";
+  }
+  return passed;
+}
+
+// Resident set size from /proc (Linux only, 0 elsewhere)
+double SoakMonitor::ReadRssKib()
+{
+  std::ifstream statm("/proc/self/statm");
+  long total_pages = 0, resident_pages = 0;
+  if (!(statm >> total_pages >> resident_pages)) return 0;
+  return static_cast<double>(resident_pages) * sysconf(_SC_PAGESIZE) / 1024.0;
+}
+
+// Live thread count from /proc (Linux only, 0 elsewhere)
+double SoakMonitor::ReadThreadCount()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) {
+      std::istringstream line_stream(line.substr(8));
+      double threads = 0;
+      line_stream >> threads;
+      return threads;
+    }
+  }
+  return 0;
+}
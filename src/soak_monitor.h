@@ -0,0 +1,69 @@
+#ifndef SOAK_MONITOR_H
+#define SOAK_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct SoakSettings
+{
+  double duration_hours;
+  std::size_t sample_interval_seconds;
+  double threshold_percent;      // allowed growth of a metric over the run
+};
+
+// Collects per-tick timings during a soak run, samples process health once
+// per interval and flags any metric that trends upward over the session.
+class SoakMonitor {
+ public:
+  explicit SoakMonitor(const SoakSettings& settings);
+  ~SoakMonitor() = default;
+
+  //Rule of 5 Implementation
+  SoakMonitor(const SoakMonitor& other) = delete;
+  SoakMonitor& operator=(const SoakMonitor& other) = delete;
+  SoakMonitor(SoakMonitor&& other) noexcept = delete;
+  SoakMonitor& operator=(SoakMonitor&& other) noexcept = delete;
+
+  void RecordTick(std::uint64_t tick_micros, int snake_size);
+  void RecordGameOver(int score);
+  bool IsFinished() const;
+
+  // Prints the summary and returns false if any metric regressed.
+  bool Report(std::ostream& out) const;
+
+ private:
+  struct Sample {
+    double elapsed_minutes;
+    double rss_kib;
+    double thread_count;
+    double tick_p50_us;
+    double tick_p99_us;
+    int snake_size;
+  };
+
+  void TakeSample(int snake_size);
+  // Growth up to noise_floor (in the metric's unit) is never a regression,
+  // so small and noisy values do not fail on a few percent of jitter.
+  bool CheckTrend(std::ostream& out, const char* metric, double Sample::*field,
+                  double noise_floor) const;
+
+  static double ReadRssKib();
+  static double ReadThreadCount();
+
+  SoakSettings settings_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point next_sample_;
+  std::chrono::steady_clock::time_point end_;
+
+  static constexpr std::size_t kThreadProbeEvery = 15;  // ticks between /proc reads
+
+  std::vector<std::uint64_t> window_ticks_;
+  double window_min_threads_;    // lowest count seen this interval, -1 if none yet
+  std::vector<Sample> samples_;
+  int games_played_;
+  int best_score_;
+};
+
+#endif
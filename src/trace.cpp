@@ -0,0 +1,218 @@
+#include "trace.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Hands the thread's ring back to the tracer when the thread exits, so the
+// next thread registering under the same track name can reuse it.
+struct RingHandle {
+  ~RingHandle() {
+    if (release != nullptr) release->store(false, std::memory_order_release);
+  }
+  void* ring{nullptr};
+  const char* track_name{nullptr};
+  std::atomic<bool>* release{nullptr};
+};
+
+thread_local RingHandle tls_ring;
+
+void WriteEscaped(std::ofstream& out, const char* text) {
+  for (const char* c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') out << '\\';
+    out << *c;
+  }
+}
+
+}  // namespace
+
+Tracer::Ring::Ring(const char* track_name, int track_id)
+    : track_name(track_name),
+      track_id(track_id),
+      in_use{true},
+      announced{false},
+      events_(new Event[kCapacity]),
+      head_{0},
+      tail_{0} {}
+
+bool Tracer::Ring::Push(const Event& event) {
+  const std::size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == kCapacity) return false;
+  events_[head & (kCapacity - 1)] = event;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+bool Tracer::Ring::Pop(Event& event) {
+  const std::size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail == head_.load(std::memory_order_acquire)) return false;
+  event = events_[tail & (kCapacity - 1)];
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+Tracer& Tracer::Instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::~Tracer() { Stop(); }
+
+bool Tracer::Start(const std::string& file_name) {
+  if (IsEnabled()) return true;
+
+  output_.open(file_name, std::ios::out | std::ios::trunc);
+  if (!output_.is_open()) {
+    std::cerr << "Could not open trace file: " << file_name << "\n";
+    return false;
+  }
+  output_ << "{\"traceEvents\":[\n";
+  first_event_ = true;
+
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto& ring : rings_) ring->announced = false;
+  }
+
+  epoch_ = std::chrono::steady_clock::now();
+  stop_writer_ = false;
+  enabled_.store(true, std::memory_order_release);
+  writer_thread_ = std::thread(&Tracer::WriterLoop, this);
+  return true;
+}
+
+void Tracer::Stop() {
+  if (!enabled_.exchange(false)) return;
+
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    stop_writer_ = true;
+  }
+  writer_cv_.notify_all();
+  if (writer_thread_.joinable()) writer_thread_.join();
+
+  output_ << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  output_.close();
+
+  const std::uint64_t dropped = dropped_events_.exchange(0);
+  if (dropped > 0) {
+    std::cerr << "Tracer dropped " << dropped << " events (ring full)\n";
+  }
+}
+
+void Tracer::RegisterThread(const char* track_name) {
+  if (tls_ring.ring != nullptr) {
+    if (std::strcmp(tls_ring.track_name, track_name) == 0) return;
+    tls_ring.release->store(false, std::memory_order_release);
+    tls_ring.ring = nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  Ring* ring = nullptr;
+  for (auto& candidate : rings_) {
+    bool expected = false;
+    if (std::strcmp(candidate->track_name, track_name) == 0 &&
+        candidate->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+      ring = candidate.get();
+      break;
+    }
+  }
+  if (ring == nullptr) {
+    rings_.push_back(std::make_unique<Ring>(track_name, static_cast<int>(rings_.size()) + 1));
+    ring = rings_.back().get();
+  }
+
+  tls_ring.ring = ring;
+  tls_ring.track_name = ring->track_name;
+  tls_ring.release = &ring->in_use;
+}
+
+Tracer::Ring* Tracer::ThreadRing() {
+  if (tls_ring.ring == nullptr) RegisterThread("Thread");
+  return static_cast<Ring*>(tls_ring.ring);
+}
+
+std::uint64_t Tracer::NowMicros() const {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - epoch_).count());
+}
+
+void Tracer::Complete(const char* name, std::uint64_t start_us, std::uint64_t duration_us) {
+  if (!IsEnabled()) return;
+  Record(Event{name, start_us, duration_us, 'X'});
+}
+
+void Tracer::Instant(const char* name) {
+  if (!IsEnabled()) return;
+  Record(Event{name, NowMicros(), 0, 'i'});
+}
+
+void Tracer::Record(const Event& event) {
+  if (!ThreadRing()->Push(event)) {
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Tracer::WriterLoop() {
+  std::unique_lock<std::mutex> lock(writer_mutex_);
+  while (!stop_writer_) {
+    writer_cv_.wait_for(lock, std::chrono::milliseconds(100));
+    lock.unlock();
+    Drain();
+    lock.lock();
+  }
+  lock.unlock();
+  Drain();
+  output_.flush();
+}
+
+void Tracer::Drain() {
+  std::vector<Ring*> rings;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings.reserve(rings_.size());
+    for (auto& ring : rings_) rings.push_back(ring.get());
+  }
+
+  Event event;
+  for (Ring* ring : rings) {
+    while (ring->Pop(event)) WriteEvent(*ring, event);
+  }
+}
+
+void Tracer::WriteEvent(Ring& ring, const Event& event) {
+  output_ << (first_event_ ? "" : ",\n");
+  first_event_ = false;
+
+  if (!ring.announced) {
+    output_ << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring.track_id
+            << ",\"args\":{\"name\":\"";
+    WriteEscaped(output_, ring.track_name);
+    output_ << "\"}},\n";
+    ring.announced = true;
+  }
+
+  output_ << "{\"name\":\"";
+  WriteEscaped(output_, event.name);
+  output_ << "\",\"cat\":\"snake\",\"ph\":\"" << event.phase << "\",\"ts\":" << event.timestamp_us
+          << ",\"pid\":1,\"tid\":" << ring.track_id;
+  if (event.phase == 'X') {
+    output_ << ",\"dur\":" << event.duration_us;
+  } else if (event.phase == 'i') {
+    output_ << ",\"s\":\"t\"";
+  }
+  output_ << "}";
+}
+
+TraceScope::TraceScope(const char* name)
+    : name_(name),
+      start_us_{},
+      active_(Tracer::Instance().IsEnabled()) {
+  if (active_) start_us_ = Tracer::Instance().NowMicros();
+}
+
+TraceScope::~TraceScope() {
+  if (!active_) return;
+  Tracer& tracer = Tracer::Instance();
+  tracer.Complete(name_, start_us_, tracer.NowMicros() - start_us_);
+}
@@ -0,0 +1,111 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Opt-in recorder for Chrome trace-event JSON (loadable in chrome://tracing
+// or ui.perfetto.dev). Every thread records into its own lock-free ring and
+// a background writer drains the rings to disk, so the game loop never
+// touches the file. Event names must be string literals (they are stored as
+// pointers, not copied).
+class Tracer {
+ public:
+  static Tracer& Instance();
+
+  ~Tracer();
+
+  //Rule of 5 Implementation
+  Tracer(const Tracer& other) = delete;
+  Tracer& operator=(const Tracer& other) = delete;
+  Tracer(Tracer&& other) noexcept = delete;
+  Tracer& operator=(Tracer&& other) noexcept = delete;
+
+  bool Start(const std::string& file_name);
+  void Stop();
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Names the calling thread's track in the viewer. Threads that share a
+  // name (e.g. successive poison food workers) share one track.
+  void RegisterThread(const char* track_name);
+
+  void Complete(const char* name, std::uint64_t start_us, std::uint64_t duration_us);
+  void Instant(const char* name);
+  std::uint64_t NowMicros() const;
+
+ private:
+  Tracer() = default;
+
+  struct Event {
+    const char* name;
+    std::uint64_t timestamp_us;
+    std::uint64_t duration_us;
+    char phase;
+  };
+
+  // Single-producer (owning thread) / single-consumer (writer) ring.
+  class Ring {
+   public:
+    Ring(const char* track_name, int track_id);
+    bool Push(const Event& event);
+    bool Pop(Event& event);
+
+    const char* track_name;
+    const int track_id;
+    std::atomic<bool> in_use;
+    bool announced;
+
+   private:
+    static constexpr std::size_t kCapacity = 8192;  // power of two
+    std::unique_ptr<Event[]> events_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+  };
+
+  Ring* ThreadRing();
+  void Record(const Event& event);
+  void WriterLoop();
+  void Drain();
+  void WriteEvent(Ring& ring, const Event& event);
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<std::uint64_t> dropped_events_{0};
+  std::chrono::steady_clock::time_point epoch_{};
+
+  std::mutex rings_mutex_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+
+  std::mutex writer_mutex_;
+  std::condition_variable writer_cv_;
+  bool stop_writer_{false};
+  std::thread writer_thread_;
+  std::ofstream output_;
+  bool first_event_{true};
+};
+
+// Records a complete ("X") event spanning the lifetime of the object.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name);
+  ~TraceScope();
+
+  TraceScope(const TraceScope& other) = delete;
+  TraceScope& operator=(const TraceScope& other) = delete;
+  TraceScope(TraceScope&& other) noexcept = delete;
+  TraceScope& operator=(TraceScope&& other) noexcept = delete;
+
+ private:
+  const char* name_;
+  std::uint64_t start_us_;
+  bool active_;
+};
+
+#endif